@@ -1,8 +1,20 @@
 #pragma once
 
+#include <chrono>
+#include <memory>
 #include "../sim/SimulationModel.h"
+#include "../sim/SimulationScheduler.h"
+#include "../sim/SimulationWorker.h"
 #include "../sim/ScenarioParams.h"
 
+// Front end of the simulation for the GUI.
+//
+// In the default mode update() steps the model on the calling thread. In
+// threaded mode a SimulationWorker owns the model and steps it on its own
+// thread; update() then only picks up the newest snapshot and drains the trail
+// sample queue into trails kept here, and commands are forwarded to the worker.
+// With the scheduler enabled, either mode advances the model by wall-clock time
+// through a SimulationScheduler instead of one step per update().
 class AppModel
 {
 public: 
@@ -10,86 +22,330 @@ public:
     {
     }
 
+    ~AppModel()
+    {
+        setThreaded(false);
+    }
+
+    void setThreaded(bool enabled)
+    {
+        if (enabled == isThreaded())
+        {
+            return;
+        }
+
+        if (enabled)
+        {
+            view_.state = sim_.state();
+            view_.time = sim_.time();
+            view_.dt = sim_.dt();
+            view_.timeScale = sim_.timeScale();
+            view_.sunPosition = sim_.sunPosition();
+            view_.earthPosition = sim_.earthPosition();
+            view_.jupiterPosition = sim_.jupiterPosition();
+            view_.seekStart = sim_.keyframes().startTime();
+            view_.seekEnd = sim_.keyframes().endTime();
+
+            viewTrajectory_ = sim_.trajectory();
+            viewEarthTrajectory_ = sim_.earthTrajectory();
+            viewJupiterTrajectory_ = sim_.jupiterTrajectory();
+
+            worker_ = std::make_unique<SimulationWorker>(sim_);
+            worker_->setPaused(paused_);
+            worker_->setScheduler(schedulerEnabled_, scheduler_.settings());
+        }
+        else
+        {
+            sim_ = worker_->stop();
+            worker_.reset();
+            restartFrameClock();
+        }
+    }
+
+    bool isThreaded() const
+    {
+        return worker_ != nullptr;
+    }
+
+    void setPaused(bool paused)
+    {
+        paused_ = paused;
+
+        if (worker_)
+        {
+            worker_->setPaused(paused);
+        }
+    }
+
+    bool isPaused() const
+    {
+        return paused_;
+    }
+
+    void setSchedulerEnabled(bool enabled)
+    {
+        schedulerEnabled_ = enabled;
+        scheduler_.reset();
+        restartFrameClock();
+
+        if (worker_)
+        {
+            worker_->setScheduler(schedulerEnabled_, scheduler_.settings());
+        }
+    }
+
+    bool isSchedulerEnabled() const
+    {
+        return schedulerEnabled_;
+    }
+
+    void setSchedulerSettings(const SchedulerSettings &settings)
+    {
+        scheduler_.setSettings(settings);
+
+        if (worker_)
+        {
+            worker_->setScheduler(schedulerEnabled_, settings);
+        }
+    }
+
+    const SchedulerSettings& schedulerSettings() const
+    {
+        return scheduler_.settings();
+    }
+
+    // Sub-stepping statistics of the most recent frame (scheduler mode only).
+    const SchedulerReport& schedulerReport() const
+    {
+        return worker_ ? view_.scheduler : scheduler_.lastReport();
+    }
+
     void update()
     {
-        sim_.update();
+        if (worker_)
+        {
+            pullSnapshot();
+            drainTrailSamples();
+            return;
+        }
+
+        if (paused_)
+        {
+            restartFrameClock();
+            return;
+        }
+
+        if (!schedulerEnabled_)
+        {
+            sim_.update();
+            return;
+        }
+
+        const Clock::time_point now = Clock::now();
+        const double wallSeconds = frameClockValid_ ? std::chrono::duration<double>(now - lastFrame_).count() : 0.0;
+        lastFrame_ = now;
+        frameClockValid_ = true;
+
+        scheduler_.advance(sim_, wallSeconds);
     }
 
     void reset(const ScenarioParams &params)
     {
+        if (worker_)
+        {
+            worker_->reset(params);
+            return;
+        }
+
         sim_.reset(params);
+        scheduler_.reset();
     }
 
     void setDt(double newDt)
     {
+        if (worker_)
+        {
+            worker_->setDt(newDt);
+            return;
+        }
+
         sim_.setDt(newDt);
     }
 
     void setMu(double newMu)
     {
+        if (worker_)
+        {
+            worker_->setMu(newMu);
+            return;
+        }
+
         sim_.setMu(newMu);
     }
 
     void setIntegrator(IntegratorType type)
     {
+        if (worker_)
+        {
+            worker_->setIntegrator(type);
+            return;
+        }
+
         sim_.setIntegrator(type);
     }
 
     double timeScale() const
     {
-        return sim_.timeScale();
+        return worker_ ? view_.timeScale : sim_.timeScale();
     }
 
     void setTimeScale(double newTimeScale)
     {
+        if (worker_)
+        {
+            worker_->setTimeScale(newTimeScale);
+            return;
+        }
+
         sim_.setTimeScale(newTimeScale);
     }
 
+    // Jumps to `time` in the recorded run; see SimulationModel::seek().
+    void seek(double time)
+    {
+        if (worker_)
+        {
+            worker_->seek(time);
+            return;
+        }
+
+        sim_.seek(time);
+        scheduler_.reset();
+        restartFrameClock();
+    }
+
+    double seekStart() const
+    {
+        return worker_ ? view_.seekStart : sim_.keyframes().startTime();
+    }
+
+    double seekEnd() const
+    {
+        return worker_ ? view_.seekEnd : sim_.keyframes().endTime();
+    }
+
     const State2& state() const
     {
-        return sim_.state();
+        return worker_ ? view_.state : sim_.state();
     }
 
     double time() const
     {
-        return sim_.time();
+        return worker_ ? view_.time : sim_.time();
     }
 
     double dt() const
     {
-        return sim_.dt();
+        return worker_ ? view_.dt : sim_.dt();
     }
 
-    const std::vector<Vector2>& trajectory() const
+    const TrajectoryBuffer& trajectory() const
     {
-        return sim_.trajectory();
+        return worker_ ? viewTrajectory_ : sim_.trajectory();
     }
 
     const Vector2& sunPosition() const
     {
-        return sim_.sunPosition();
+        return worker_ ? view_.sunPosition : sim_.sunPosition();
     }
 
     const Vector2& jupiterPosition() const
     {
-        return sim_.jupiterPosition();
+        return worker_ ? view_.jupiterPosition : sim_.jupiterPosition();
     }
 
-    const std::vector<Vector2>& jupiterTrajectory() const
+    const TrajectoryBuffer& jupiterTrajectory() const
     {
-        return sim_.jupiterTrajectory();
+        return worker_ ? viewJupiterTrajectory_ : sim_.jupiterTrajectory();
     }
 
     const Vector2& earthPosition() const
     {
-        return sim_.earthPosition();
+        return worker_ ? view_.earthPosition : sim_.earthPosition();
     }
 
-    const std::vector<Vector2>& earthTrajectory() const
+    const TrajectoryBuffer& earthTrajectory() const
     {
-        return sim_.earthTrajectory();
+        return worker_ ? viewEarthTrajectory_ : sim_.earthTrajectory();
     }
 
 private:
+    using Clock = std::chrono::steady_clock;
+
+    // The next scheduled frame measures its wall time from scratch.
+    void restartFrameClock()
+    {
+        frameClockValid_ = false;
+    }
+
+    void pullSnapshot()
+    {
+        const SimulationSnapshot *snapshot = worker_->takeSnapshot();
+        if (!snapshot)
+        {
+            return;
+        }
+
+        view_ = *snapshot;
+    }
+
+    void drainTrailSamples()
+    {
+        worker_->trailQueue().drain([this](const TrailSample &sample)
+        {
+            TrajectoryBuffer &trail = viewTrailFor(sample.body);
+
+            switch (sample.kind)
+            {
+            case TrailSampleKind::Point:
+                trail.addPoint(sample.position);
+                break;
+            case TrailSampleKind::Break:
+                trail.addBreak();
+                break;
+            case TrailSampleKind::Clear:
+                trail.clear();
+                break;
+            }
+        });
+    }
+
+    TrajectoryBuffer& viewTrailFor(TrailBody body)
+    {
+        switch (body)
+        {
+        case TrailBody::Earth:
+            return viewEarthTrajectory_;
+        case TrailBody::Jupiter:
+            return viewJupiterTrajectory_;
+        case TrailBody::Ship:
+        default:
+            return viewTrajectory_;
+        }
+    }
+
     SimulationModel sim_;
-};
\ No newline at end of file
+    bool paused_ = false;
+
+    SimulationScheduler scheduler_;
+    bool schedulerEnabled_ = false;
+    Clock::time_point lastFrame_;
+    bool frameClockValid_ = false;
+
+    // Threaded mode: the worker owns the model; these are the GUI's copies.
+    std::unique_ptr<SimulationWorker> worker_;
+    SimulationSnapshot view_;
+    TrajectoryBuffer viewTrajectory_;
+    TrajectoryBuffer viewEarthTrajectory_;
+    TrajectoryBuffer viewJupiterTrajectory_;
+};
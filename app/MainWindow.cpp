@@ -1,4 +1,5 @@
 #include "MainWindow.h"
+#include <algorithm>
 #include <cmath>
 #include <QString>
 #include <QVBoxLayout>
@@ -7,6 +8,7 @@
 #include <QScrollArea>
 #include <QWidget>
 #include <QFont>
+#include <QSignalBlocker>
 
 double MainWindow::timeScaleForSpeed(MainWindow::SimulationSpeed speed) const
 {
@@ -27,6 +29,25 @@ double MainWindow::timeScaleForSpeed(MainWindow::SimulationSpeed speed) const
     }
 }
 
+void MainWindow::applySchedulerSettings(double dt)
+{
+    if (!appModel_)
+    {
+        return;
+    }
+
+    // Same rate as the plain mode, which takes one dt * timeScale step per 20 ms tick.
+    const double ticksPerSecond = 1000.0 / m_timer->interval();
+    const double legacyStep = dt * timeScaleForSpeed(simulationSpeed_);
+
+    SchedulerSettings settings = appModel_->schedulerSettings();
+    settings.simSecondsPerWallSecond = ticksPerSecond * legacyStep;
+    settings.maxStep = maxStepSpin_->value() * 3600.0;
+    settings.trailInterval = legacyStep;
+
+    appModel_->setSchedulerSettings(settings);
+}
+
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
 {
@@ -77,8 +98,21 @@ MainWindow::MainWindow(QWidget *parent)
     autoAlignPlanetCheck_ = new QCheckBox(tr("Auto-align planet (assist)"), this);
     autoAlignPlanetCheck_->setChecked(false);
 
+    threadedCheck_ = new QCheckBox(tr("Run on worker thread"), this);
+    threadedCheck_->setChecked(false);
+
+    schedulerCheck_ = new QCheckBox(tr("Fixed-step scheduler"), this);
+    schedulerCheck_->setChecked(false);
+
+    maxStepSpin_ = new QDoubleSpinBox(this);
+    maxStepSpin_->setRange(0.01, 1000.0);
+    maxStepSpin_->setDecimals(2);
+    maxStepSpin_->setValue(24.0);
+
     initButton_ = new QPushButton(tr("Initialize"), this);
 
+    sweepButton_ = new QPushButton(tr("Sweep launch window"), this);
+
     timeLabel_ = new QLabel(tr("Time: 0.00 yr"), this);
     timeLabel_->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
 
@@ -91,6 +125,9 @@ MainWindow::MainWindow(QWidget *parent)
     timeScaleLabel_ = new QLabel(tr("Time scale: 0.00 yr/s"), this);
     timeScaleLabel_->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
 
+    schedulerLabel_ = new QLabel(tr("Steps/frame: -"), this);
+    schedulerLabel_->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
+
     QFont infoFont;
     infoFont.setPointSize(11); 
     infoFont.setBold(true);
@@ -103,6 +140,13 @@ MainWindow::MainWindow(QWidget *parent)
     orbitView_->setMinimumHeight(400);
     orbitView_->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 
+    timelineSlider_ = new QSlider(Qt::Horizontal, this);
+    timelineSlider_->setRange(0, 1000);
+    timelineSlider_->setValue(0);
+
+    timelineLabel_ = new QLabel(tr("0.00 / 0.00 yr"), this);
+    timelineLabel_->setMinimumWidth(110);
+
     //Layout
 
     //Status
@@ -113,6 +157,7 @@ MainWindow::MainWindow(QWidget *parent)
     statusLayout->addWidget(speedLabel_);
     statusLayout->addWidget(positionPolarLabel_);
     statusLayout->addWidget(timeScaleLabel_);
+    statusLayout->addWidget(schedulerLabel_);
 
     //Left
     QWidget *leftPanel = new QWidget(central);
@@ -120,6 +165,11 @@ MainWindow::MainWindow(QWidget *parent)
 
     leftLayout->addWidget(orbitView_, /*stretch*/ 1);
 
+    QHBoxLayout *timelineLayout = new QHBoxLayout();
+    timelineLayout->addWidget(timelineSlider_, 1);
+    timelineLayout->addWidget(timelineLabel_);
+    leftLayout->addLayout(timelineLayout);
+
     leftLayout->setContentsMargins(0, 0, 0, 0);
 
     //Right
@@ -149,8 +199,14 @@ MainWindow::MainWindow(QWidget *parent)
     rightLayout->addWidget(clearTrailsCheck_);
     rightLayout->addWidget(autoAlignPlanetCheck_);
     rightLayout->addWidget(initButton_);
+    rightLayout->addWidget(sweepButton_);
 
     rightLayout->addWidget(m_pauseButton);
+    rightLayout->addWidget(threadedCheck_);
+    rightLayout->addWidget(schedulerCheck_);
+
+    rightLayout->addWidget(new QLabel(tr("Max step (hours)"), this));
+    rightLayout->addWidget(maxStepSpin_);
 
     rightLayout->addWidget(statusBox);
 
@@ -190,6 +246,8 @@ MainWindow::MainWindow(QWidget *parent)
 
     m_timer->start();
 
+    applySchedulerSettings(appModel_->dt());
+
     connect(speedComboBox_, QOverload<int>::of(&QComboBox::currentIndexChanged), this,
     [this](int index)
     {
@@ -200,6 +258,7 @@ MainWindow::MainWindow(QWidget *parent)
         {
             const double ts = timeScaleForSpeed(simulationSpeed_);
             appModel_->setTimeScale(ts);
+            applySchedulerSettings(appModel_->dt());
         }
     });
 
@@ -234,17 +293,81 @@ MainWindow::MainWindow(QWidget *parent)
                 if (appModel_)
                 {
                     appModel_->reset(params);
+                    applySchedulerSettings(params.dt);
                 }
             });
 
     connect(m_pauseButton, &QPushButton::clicked, this, &MainWindow::onPauseClicked);
+
+    connect(threadedCheck_, &QCheckBox::toggled, this,
+    [this](bool checked)
+    {
+        if (appModel_)
+        {
+            appModel_->setThreaded(checked);
+            orbitView_->invalidateStaticLayer();
+        }
+    });
+
+    connect(schedulerCheck_, &QCheckBox::toggled, this,
+    [this](bool checked)
+    {
+        if (appModel_)
+        {
+            applySchedulerSettings(appModel_->dt());
+            appModel_->setSchedulerEnabled(checked);
+        }
+    });
+
+    connect(maxStepSpin_, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this,
+    [this](double)
+    {
+        applySchedulerSettings(appModel_->dt());
+    });
+
+    connect(sweepButton_, &QPushButton::clicked, this, &MainWindow::startLaunchWindowSweep);
+
+    connect(timelineSlider_, &QSlider::sliderPressed, this, [this]() { setPaused(true); });
+    connect(timelineSlider_, &QSlider::valueChanged, this, &MainWindow::onTimelineChanged);
 }
 
 MainWindow::~MainWindow()
 {
+    delete sweepView_;
     delete appModel_;
 }
 
+void MainWindow::startLaunchWindowSweep()
+{
+    if (!sweepView_)
+    {
+        // Top-level window; deleted in the destructor.
+        sweepView_ = new SweepHeatmapWidget();
+
+        connect(sweepView_, &SweepHeatmapWidget::cellPicked, this,
+        [this](double speed, double angleDeg)
+        {
+            v0Spin_->setValue(speed);
+            fi0Spin_->setValue(angleDeg);
+        });
+    }
+
+    constexpr int gridSize = 40;
+
+    const double v0 = v0Spin_->value();
+    const double fi0 = fi0Spin_->value();
+
+    SweepSpec spec;
+    spec.radiusAu = SweepRange{ x0Spin_->value(), x0Spin_->value(), 1 };
+    spec.phaseDeg = SweepRange{ y0Spin_->value(), y0Spin_->value(), 1 };
+    spec.speed = SweepRange{ std::max(v0 - 10.0, 0.0), v0 + 10.0, gridSize };
+    spec.angleDeg = SweepRange{ fi0 - 30.0, fi0 + 30.0, gridSize };
+
+    sweepView_->startSweep(spec);
+    sweepView_->show();
+    sweepView_->raise();
+}
+
 void MainWindow::onSimulationTick()
 {
     if (!appModel_)
@@ -252,13 +375,12 @@ void MainWindow::onSimulationTick()
         return;
     }
 
-    if (!isPaused_)
-    {
-        appModel_->update();
-    }
+    appModel_->update();
 
     orbitView_->update();
 
+    updateTimeline();
+
     if (timeLabel_ && speedLabel_ && appModel_)
     {
         const double secondsPerYear = 365.0 * 24.0 * 3600.0;
@@ -296,6 +418,18 @@ void MainWindow::onSimulationTick()
         timeScaleLabel_->setText(
             tr("Time scale: %1 yr/s").arg(timeScaleYearsPerSecond, 0, 'f', 3)
         );
+
+        if (appModel_->isSchedulerEnabled())
+        {
+            const SchedulerReport &report = appModel_->schedulerReport();
+            const QString behind = report.fallingBehind ? tr(" (falling behind)") : QString();
+
+            schedulerLabel_->setText(tr("Steps/frame: %1%2").arg(report.steps).arg(behind));
+        }
+        else
+        {
+            schedulerLabel_->setText(tr("Steps/frame: -"));
+        }
     }
 }
 
@@ -306,7 +440,17 @@ void MainWindow::onPauseClicked()
         return;
     }
 
-    isPaused_ = !isPaused_;
+    setPaused(!isPaused_);
+}
+
+void MainWindow::setPaused(bool paused)
+{
+    isPaused_ = paused;
+
+    if (appModel_)
+    {
+        appModel_->setPaused(isPaused_);
+    }
 
     if (isPaused_)
     {
@@ -316,4 +460,47 @@ void MainWindow::onPauseClicked()
     {
         m_pauseButton->setText(tr("Pause"));
     }
-}
\ No newline at end of file
+}
+
+void MainWindow::onTimelineChanged(int value)
+{
+    if (!appModel_)
+    {
+        return;
+    }
+
+    // Only user input gets here; updateTimeline() blocks the signal.
+    setPaused(true);
+
+    const double start = appModel_->seekStart();
+    const double end = appModel_->seekEnd();
+    const double fraction = static_cast<double>(value - timelineSlider_->minimum())
+                          / static_cast<double>(timelineSlider_->maximum() - timelineSlider_->minimum());
+
+    appModel_->seek(start + fraction * (end - start));
+
+    appModel_->update();
+    orbitView_->update();
+}
+
+void MainWindow::updateTimeline()
+{
+    const double secondsPerYear = 365.0 * 24.0 * 3600.0;
+
+    const double start = appModel_->seekStart();
+    const double end = appModel_->seekEnd();
+    const double t = appModel_->time();
+
+    timelineLabel_->setText(tr("%1 / %2 yr").arg(t / secondsPerYear, 0, 'f', 2).arg(end / secondsPerYear, 0, 'f', 2));
+
+    if (timelineSlider_->isSliderDown() || end <= start)
+    {
+        return;
+    }
+
+    const double fraction = std::clamp((t - start) / (end - start), 0.0, 1.0);
+    const int range = timelineSlider_->maximum() - timelineSlider_->minimum();
+
+    const QSignalBlocker blocker(timelineSlider_);
+    timelineSlider_->setValue(timelineSlider_->minimum() + static_cast<int>(std::lround(fraction * range)));
+}
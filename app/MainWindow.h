@@ -7,8 +7,10 @@
 #include <QComboBox>
 #include <QDoubleSpinBox>
 #include <QCheckBox>
+#include <QSlider>
 #include "AppModel.h"
 #include "OrbitViewWidget.h"
+#include "SweepHeatmapWidget.h"
 
 class MainWindow : public QMainWindow
 {
@@ -23,6 +25,7 @@ public:
 private slots:
     void onSimulationTick();
     void onPauseClicked();
+    void onTimelineChanged(int value);
 
 private:
     QPushButton *m_pauseButton = nullptr;
@@ -36,16 +39,27 @@ private:
     QDoubleSpinBox *v0Spin_ = nullptr;
     QDoubleSpinBox *fi0Spin_ = nullptr;
     QDoubleSpinBox *dtSpin_ = nullptr;
+    QDoubleSpinBox *maxStepSpin_ = nullptr;
 
     QLabel *timeLabel_ = nullptr;
     QLabel *speedLabel_ = nullptr;
     QLabel *positionPolarLabel_ = nullptr;
     QLabel *timeScaleLabel_ = nullptr;
+    QLabel *schedulerLabel_ = nullptr;
 
     QCheckBox *clearTrailsCheck_ = nullptr;
     QCheckBox *autoAlignPlanetCheck_ = nullptr;
+    QCheckBox *threadedCheck_ = nullptr;
+    QCheckBox *schedulerCheck_ = nullptr;
 
     QPushButton *initButton_ = nullptr;
+    QPushButton *sweepButton_ = nullptr;
+
+    SweepHeatmapWidget *sweepView_ = nullptr;
+
+    // Scrubs through the recorded part of the run (see SimulationModel::seek()).
+    QSlider *timelineSlider_ = nullptr;
+    QLabel *timelineLabel_ = nullptr;
 
     enum class SimulationSpeed
     {
@@ -60,5 +74,16 @@ private:
 
     double timeScaleForSpeed(SimulationSpeed speed) const;
 
+    // Pushes the current speed, the given dt and the max step into the scheduler settings.
+    void applySchedulerSettings(double dt);
+
+    // Opens the sweep view on a speed/angle grid around the current launch parameters.
+    void startLaunchWindowSweep();
+
+    void setPaused(bool paused);
+
+    // Moves the slider to the current time without seeking.
+    void updateTimeline();
+
     bool isPaused_ = false;
 };
\ No newline at end of file
@@ -12,6 +12,7 @@ OrbitViewWidget::OrbitViewWidget(QWidget *parent) : QWidget(parent), appModel_(n
 void OrbitViewWidget::setAppModel(AppModel *model)
 {
     appModel_ = model;
+    invalidateStaticLayer();
     autoFitSolarSystem();
     update();
 }
@@ -19,10 +20,11 @@ void OrbitViewWidget::setAppModel(AppModel *model)
 void OrbitViewWidget::setWorldBounds(double minX, double maxX, double minY, double maxY)
 {
     converter_.setWorldBounds(minX, maxX, minY, maxY);
+    invalidateStaticLayer();
     update();
 }
 
-void OrbitViewWidget::autoFitBounds(const std::vector<Vector2> &trajectory)
+void OrbitViewWidget::autoFitBounds(const TrajectoryBuffer &trajectory)
 {
     if (trajectory.empty())
     {
@@ -34,13 +36,13 @@ void OrbitViewWidget::autoFitBounds(const std::vector<Vector2> &trajectory)
     double minY = trajectory[0].y;
     double maxY = trajectory[0].y;
 
-    for (const Vector2 &p : trajectory)
+    trajectory.forEach([&](const Vector2 &p)
     {
         if (p.x < minX) minX = p.x;
         if (p.x > maxX) maxX = p.x;
         if (p.y < minY) minY = p.y;
         if (p.y > maxY) maxY = p.y;
-    }
+    });
 
     double dx = (maxX - minX) * 0.10;
     double dy = (maxY - minY) * 0.10;
@@ -69,7 +71,7 @@ void OrbitViewWidget::autoFitSolarSystem()
 
     double viewR = (rEarth > rJupiter) ? rEarth : rJupiter;
 
-    const std::vector<Vector2> &traj = appModel_->trajectory();
+    const TrajectoryBuffer &traj = appModel_->trajectory();
     if (viewR <= 0.0 && !traj.empty())
     {
         autoFitBounds(traj);
@@ -84,6 +86,7 @@ void OrbitViewWidget::autoFitSolarSystem()
 void OrbitViewWidget::resizeEvent(QResizeEvent *event)
 {
     converter_.setScreenSize(width(), height());
+    invalidateStaticLayer();
     autoFitSolarSystem();
     QWidget::resizeEvent(event);
 }
@@ -95,13 +98,178 @@ void OrbitViewWidget::paintEvent(QPaintEvent *event)
     QPainter painter(this);
     painter.setRenderHint(QPainter::Antialiasing, true);
 
-    painter.fillRect(rect(), QColor(10, 10, 30));
-
     if (!appModel_)
     {
+        painter.fillRect(rect(), QColor(10, 10, 30));
+        return;
+    }
+
+    updateStaticLayer();
+    painter.drawPixmap(0, 0, staticLayer_);
+
+    //Sun
+    const Vector2 sunWorld = appModel_->sunPosition();
+    const ScreenPoint sunScreen = converter_.toScreen(sunWorld);
+
+    painter.setBrush(QBrush(Qt::yellow));
+    painter.setPen(Qt::NoPen);
+    painter.drawEllipse(QPointF(sunScreen.x, sunScreen.y), 6.0, 6.0);
+
+    //Jupiter
+    const Vector2 jupiterWorld = appModel_->jupiterPosition();
+    const ScreenPoint jupiterScreen = converter_.toScreen(jupiterWorld);
+
+    painter.setBrush(QBrush(QColor(255, 165, 0))); 
+    painter.setPen(Qt::NoPen);
+    painter.drawEllipse(QPointF(jupiterScreen.x, jupiterScreen.y), 5.0, 5.0);
+
+    //Earth
+    const Vector2 earthWorld = appModel_->earthPosition();
+    const ScreenPoint earthScreen = converter_.toScreen(earthWorld);
+
+    painter.setBrush(QBrush(QColor(100, 170, 255))); 
+    painter.setPen(Qt::NoPen);
+    painter.drawEllipse(QPointF(earthScreen.x, earthScreen.y), 4.0, 4.0);
+
+    //Ship
+    if (appModel_->trajectory().empty())
+    {
+        return;
+    }
+
+    const State2 &st = appModel_->state();
+    ScreenPoint sp = converter_.toScreen(st.position);
+
+    painter.setBrush(Qt::yellow);
+    painter.setPen(Qt::NoPen);
+    painter.drawEllipse(QPointF(sp.x, sp.y), 4.0, 4.0);
+}
+
+const TrailRenderer::Stats& OrbitViewWidget::trailRenderStats() const
+{
+    return trailRenderer_.stats();
+}
+
+WorldRect OrbitViewWidget::cullingRect() const
+{
+    // Widen the visible area by a few pixels so thick pens at the edge are not cut off.
+    const double marginPx = 4.0;
+    return converter_.visibleWorldRect().expanded(marginPx * converter_.worldUnitsPerPixel());
+}
+
+void OrbitViewWidget::invalidateStaticLayer()
+{
+    staticLayerValid_ = false;
+}
+
+const TrajectoryBuffer& OrbitViewWidget::trailForLayer(int index) const
+{
+    switch (index)
+    {
+    case 0:
+        return appModel_->jupiterTrajectory();
+    case 1:
+        return appModel_->earthTrajectory();
+    default:
+        return appModel_->trajectory();
+    }
+}
+
+QPen OrbitViewWidget::penForLayer(int index) const
+{
+    QPen pen;
+
+    switch (index)
+    {
+    case 0:
+        pen = QPen(QColor(255, 165, 0));
+        break;
+    case 1:
+        pen = QPen(QColor(100, 170, 255));
+        break;
+    default:
+        pen = QPen(Qt::cyan);
+        break;
+    }
+
+    pen.setWidth(2);
+    return pen;
+}
+
+void OrbitViewWidget::updateStaticLayer()
+{
+    const qreal dpr = devicePixelRatioF();
+    const QSize pixelSize = size() * dpr;
+
+    bool rebuild = !staticLayerValid_ || staticLayer_.size() != pixelSize;
+
+    for (int i = 0; i < trailLayerCount && !rebuild; ++i)
+    {
+        const TrajectoryBuffer &trail = trailForLayer(i);
+        const TrailCacheState &cache = trailCache_[i];
+
+        // Reset/clear renumbers the trail. Evicted points stay in the cache until
+        // an eighth of the trail has been replaced, then the layer is redrawn.
+        const std::uint64_t evicted = trail.firstIndex() - cache.firstIndex;
+        if (cache.generation != trail.generation() ||
+            trail.firstIndex() < cache.firstIndex ||
+            (evicted > 0 && evicted >= trail.size() / 8))
+        {
+            rebuild = true;
+        }
+    }
+
+    if (rebuild)
+    {
+        staticLayer_ = QPixmap(pixelSize);
+        staticLayer_.setDevicePixelRatio(dpr);
+        staticLayer_.fill(QColor(10, 10, 30));
+
+        QPainter painter(&staticLayer_);
+        painter.setRenderHint(QPainter::Antialiasing, true);
+
+        drawAxes(painter);
+
+        // Trails are simplified so that no detail smaller than about half a pixel is drawn.
+        const double lodTolerance = 0.5 * converter_.worldUnitsPerPixel();
+        const WorldRect view = cullingRect();
+
+        trailRenderer_.resetStats();
+
+        for (int i = 0; i < trailLayerCount; ++i)
+        {
+            const TrajectoryBuffer &trail = trailForLayer(i);
+            trailRenderer_.draw(painter, trail, converter_, penForLayer(i), lodTolerance, view);
+
+            trailCache_[i].generation = trail.generation();
+            trailCache_[i].firstIndex = trail.firstIndex();
+            trailCache_[i].drawnEnd = trail.endIndex();
+        }
+
+        staticLayerValid_ = true;
         return;
     }
 
+    QPainter painter(&staticLayer_);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+
+    const WorldRect view = cullingRect();
+
+    for (int i = 0; i < trailLayerCount; ++i)
+    {
+        const TrajectoryBuffer &trail = trailForLayer(i);
+        TrailCacheState &cache = trailCache_[i];
+
+        if (trail.endIndex() > cache.drawnEnd)
+        {
+            trailRenderer_.drawAppended(painter, trail, cache.drawnEnd, converter_, penForLayer(i), view);
+            cache.drawnEnd = trail.endIndex();
+        }
+    }
+}
+
+void OrbitViewWidget::drawAxes(QPainter &painter)
+{
     painter.setPen(QPen(QColor(80, 80, 80), 1));
 
     const ScreenPoint originScreen = converter_.toScreen(Vector2(0.0, 0.0));
@@ -159,132 +327,4 @@ void OrbitViewWidget::paintEvent(QPaintEvent *event)
         painter.drawLine(QPointF(originScreen.x - tickHalfPx, p.y),
                          QPointF(originScreen.x + tickHalfPx, p.y));
     }
-
-    //Sun
-    const Vector2 sunWorld = appModel_->sunPosition();
-    const ScreenPoint sunScreen = converter_.toScreen(sunWorld);
-
-    painter.setBrush(QBrush(Qt::yellow));
-    painter.setPen(Qt::NoPen);
-    painter.drawEllipse(QPointF(sunScreen.x, sunScreen.y), 6.0, 6.0);
-
-    //Jupiter
-    const Vector2 jupiterWorld = appModel_->jupiterPosition();
-    const ScreenPoint jupiterScreen = converter_.toScreen(jupiterWorld);
-
-    painter.setBrush(QBrush(QColor(255, 165, 0))); 
-    painter.setPen(Qt::NoPen);
-    painter.drawEllipse(QPointF(jupiterScreen.x, jupiterScreen.y), 5.0, 5.0);
-
-    const std::vector<Vector2> &jupiterTraj = appModel_->jupiterTrajectory();
-    if (!jupiterTraj.empty())
-    {
-        QPen jupiterPen(QColor(255, 165, 0));
-        jupiterPen.setWidth(2);
-        painter.setPen(jupiterPen);
-
-        QPointF prev;
-        bool first = true;
-
-        for (const Vector2 &p : jupiterTraj)
-        {
-            if (TrajectoryBuffer::isBreakPoint(p))
-            {
-                first = true;
-                continue;
-            }
-
-            const ScreenPoint sp = converter_.toScreen(p);
-            const QPointF pt(sp.x, sp.y);
-
-            if (!first)
-            {
-                painter.drawLine(prev, pt);
-            }
-
-            prev = pt;
-            first = false;
-        }
-    }
-
-    //Earth
-    const Vector2 earthWorld = appModel_->earthPosition();
-    const ScreenPoint earthScreen = converter_.toScreen(earthWorld);
-
-    painter.setBrush(QBrush(QColor(100, 170, 255))); 
-    painter.setPen(Qt::NoPen);
-    painter.drawEllipse(QPointF(earthScreen.x, earthScreen.y), 4.0, 4.0);
-
-    const std::vector<Vector2> &earthTraj = appModel_->earthTrajectory();
-    if (!earthTraj.empty())
-    {
-        QPen earthPen(QColor(100, 170, 255));
-        earthPen.setWidth(2);
-        painter.setPen(earthPen);
-
-        QPointF prev;
-        bool first = true;
-
-        for (const Vector2 &p : earthTraj)
-        {
-            if (TrajectoryBuffer::isBreakPoint(p))
-            {
-                first = true;
-                continue;
-            }
-
-            const ScreenPoint sp = converter_.toScreen(p);
-            const QPointF pt(sp.x, sp.y);
-
-            if (!first)
-            {
-                painter.drawLine(prev, pt);
-            }
-
-            prev = pt;
-            first = false;
-        }
-    }
-
-    //Ship
-    const std::vector<Vector2> &traj = appModel_->trajectory();
-    if (traj.empty())
-    {
-        return;
-    }
-
-    QPen pen(Qt::cyan);
-    pen.setWidth(2);
-    painter.setPen(pen);
-
-    QPointF prevPoint;
-    bool first = true;
-
-    for (const Vector2 &p : traj)
-    {
-        if (TrajectoryBuffer::isBreakPoint(p))
-        {
-            first = true;
-            continue;
-        }
-
-        ScreenPoint sp = converter_.toScreen(p);
-        QPointF screenPt(sp.x, sp.y);
-
-        if (!first)
-        {
-            painter.drawLine(prevPoint, screenPt);
-        }
-
-        prevPoint = screenPt;
-        first = false;
-    }
-
-    const State2 &st = appModel_->state();
-    ScreenPoint sp = converter_.toScreen(st.position);
-
-    painter.setBrush(Qt::yellow);
-    painter.setPen(Qt::NoPen);
-    painter.drawEllipse(QPointF(sp.x, sp.y), 4.0, 4.0);
 }
-
@@ -1,9 +1,13 @@
 #pragma once
 
 #include <QWidget>
+#include <QPixmap>
+#include <QPen>
+#include <cstdint>
 #include <vector>
 #include "AppModel.h"
 #include "ScreenSpaceConverter.h"
+#include "TrailRenderer.h"
 
 class OrbitViewWidget : public QWidget
 {
@@ -14,15 +18,45 @@ public:
 
     void setAppModel(AppModel *model);
     void setWorldBounds(double minX, double maxX, double minY, double maxY);
-    void autoFitBounds(const std::vector<Vector2> &trajectory);
+    void autoFitBounds(const TrajectoryBuffer &trajectory);
     void autoFitSolarSystem();
 
+    // Trail segments drawn and culled since the static layer was last rebuilt
+    // (the rebuild itself plus the segments appended after it).
+    const TrailRenderer::Stats& trailRenderStats() const;
+
+    // Forces the cached static layer to be redrawn on the next paint.
+    void invalidateStaticLayer();
+
 
 protected:
     void resizeEvent(QResizeEvent *event) override;
     void paintEvent(QPaintEvent *event) override;
 
 private:
+    // Static layer: background, axes, ticks and trail history. It is redrawn from
+    // scratch only when the view changes or a trail is reset; otherwise each frame
+    // only appends the newly added trail segments to it.
+    struct TrailCacheState
+    {
+        std::uint64_t generation = 0;
+        std::uint64_t firstIndex = 0; // oldest trail point when the layer was rebuilt
+        std::uint64_t drawnEnd = 0;   // trail points [.., drawnEnd) are in the layer
+    };
+
+    static constexpr int trailLayerCount = 3; // Jupiter, Earth, ship
+
+    void updateStaticLayer();
+    void drawAxes(QPainter &painter);
+    WorldRect cullingRect() const;
+    const TrajectoryBuffer& trailForLayer(int index) const;
+    QPen penForLayer(int index) const;
+
     AppModel *appModel_;
     ScreenSpaceConverter converter_;
+    TrailRenderer trailRenderer_;
+
+    QPixmap staticLayer_;
+    bool staticLayerValid_ = false;
+    TrailCacheState trailCache_[trailLayerCount];
 };
\ No newline at end of file
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstddef>
+#include <span>
 #include "../core/Vector2.h"
+#include "../core/WorldRect.h"
 
 struct ScreenPoint
 {
@@ -8,6 +11,9 @@ struct ScreenPoint
     double y;
 };
 
+// Maps world coordinates to screen pixels with a uniform scale that fits the
+// world bounds into the screen, centred, with the y axis pointing up.
+// The transform is recomputed only when the bounds or the screen size change.
 class ScreenSpaceConverter
 {
 public:
@@ -19,6 +25,7 @@ public:
           screenWidth_(800),
           screenHeight_(600)
     {
+        updateTransform();
     }
 
     void setWorldBounds(double minX, double maxX, double minY, double maxY)
@@ -27,56 +34,112 @@ public:
         worldMaxX_ = maxX;
         worldMinY_ = minY;
         worldMaxY_ = maxY;
+        updateTransform();
     }
 
     void setScreenSize(int width, int height)
     {
         screenWidth_ = width;
         screenHeight_ = height;
+        updateTransform();
     }
 
     ScreenPoint toScreen(const Vector2 &world) const
     {
         ScreenPoint result;
-        result.x = 0.0;
-        result.y = 0.0;
+        result.x = screenCenterX_ + (world.x - worldCenterX_) * scale_;
+        result.y = screenCenterY_ - (world.y - worldCenterY_) * scale_;
+        return result;
+    }
+
+    // Maps world[i] to out[i]; `out` must have room for world.size() points.
+    // The loop is branch-free so the compiler can vectorize it; break markers
+    // (NaN) map to NaN and are passed through unchanged in meaning.
+    void toScreen(std::span<const Vector2> world, ScreenPoint *out) const
+    {
+        // Same operations on x and y (y uses a negated scale) so each point maps
+        // with one vector subtract, multiply and add.
+        const double scaleX = scale_;
+        const double scaleY = -scale_;
+        const double worldCenterX = worldCenterX_;
+        const double worldCenterY = worldCenterY_;
+        const double screenCenterX = screenCenterX_;
+        const double screenCenterY = screenCenterY_;
+
+        const Vector2 *in = world.data();
+        const std::size_t count = world.size();
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            out[i].x = screenCenterX + (in[i].x - worldCenterX) * scaleX;
+            out[i].y = screenCenterY + (in[i].y - worldCenterY) * scaleY;
+        }
+    }
+
+    // Size of one screen pixel in world units (0 if the mapping is degenerate).
+    double worldUnitsPerPixel() const
+    {
+        return (scale_ > 0.0) ? 1.0 / scale_ : 0.0;
+    }
+
+    // World rectangle covered by the whole screen. Because the scale is uniform this
+    // can be larger than the world bounds along one axis.
+    WorldRect visibleWorldRect() const
+    {
+        WorldRect rect;
+        rect.min = Vector2(worldMinX_, worldMinY_);
+        rect.max = Vector2(worldMaxX_, worldMaxY_);
+
+        const double unitsPerPixel = worldUnitsPerPixel();
+        if (unitsPerPixel <= 0.0)
+        {
+            return rect;
+        }
+
+        const double halfWidth = 0.5 * static_cast<double>(screenWidth_) * unitsPerPixel;
+        const double halfHeight = 0.5 * static_cast<double>(screenHeight_) * unitsPerPixel;
+
+        rect.min = Vector2(worldCenterX_ - halfWidth, worldCenterY_ - halfHeight);
+        rect.max = Vector2(worldCenterX_ + halfWidth, worldCenterY_ + halfHeight);
+        return rect;
+    }
+
+private:
+    // Degenerate cases keep the old behaviour: an empty screen maps everything
+    // to (0, 0) and empty world bounds map everything to the screen centre.
+    void updateTransform()
+    {
+        scale_ = 0.0;
+        worldCenterX_ = 0.0;
+        worldCenterY_ = 0.0;
+        screenCenterX_ = 0.0;
+        screenCenterY_ = 0.0;
 
         if (screenWidth_ <= 0 || screenHeight_ <= 0)
         {
-            return result;
+            return;
         }
 
+        screenCenterX_ = static_cast<double>(screenWidth_) * 0.5;
+        screenCenterY_ = static_cast<double>(screenHeight_) * 0.5;
+
         const double worldWidth = worldMaxX_ - worldMinX_;
         const double worldHeight = worldMaxY_ - worldMinY_;
 
         if (worldWidth <= 0.0 || worldHeight <= 0.0)
         {
-            result.x = static_cast<double>(screenWidth_) * 0.5;
-            result.y = static_cast<double>(screenHeight_) * 0.5;
-            return result;
+            return;
         }
 
         const double scaleX = static_cast<double>(screenWidth_) / worldWidth;
         const double scaleY = static_cast<double>(screenHeight_) / worldHeight;
 
-        const double scale = (scaleX < scaleY) ? scaleX : scaleY;
-
-        const double worldCenterX = 0.5 * (worldMinX_ + worldMaxX_);
-        const double worldCenterY = 0.5 * (worldMinY_ + worldMaxY_);
+        scale_ = (scaleX < scaleY) ? scaleX : scaleY;
 
-        const double screenCenterX = static_cast<double>(screenWidth_) * 0.5;
-        const double screenCenterY = static_cast<double>(screenHeight_) * 0.5;
-
-        const double dx = world.x - worldCenterX;
-        const double dy = world.y - worldCenterY;
-
-        result.x = screenCenterX + dx * scale;
-        result.y = screenCenterY - dy * scale;
-
-        return result;
+        worldCenterX_ = 0.5 * (worldMinX_ + worldMaxX_);
+        worldCenterY_ = 0.5 * (worldMinY_ + worldMaxY_);
     }
 
-private:
     double worldMinX_;
     double worldMaxX_;
     double worldMinY_;
@@ -84,4 +147,11 @@ private:
 
     int screenWidth_;
     int screenHeight_;
-};
\ No newline at end of file
+
+    // Cached transform: screen = screenCenter + (world - worldCenter) * scale (y flipped)
+    double scale_ = 0.0;
+    double worldCenterX_ = 0.0;
+    double worldCenterY_ = 0.0;
+    double screenCenterX_ = 0.0;
+    double screenCenterY_ = 0.0;
+};
@@ -0,0 +1,217 @@
+#include "SweepHeatmapWidget.h"
+#include <algorithm>
+#include <cmath>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QVBoxLayout>
+
+namespace
+{
+    // Colour scale limits for the closest approach to Jupiter [km].
+    constexpr double nearDistance = 1.0e5;
+    constexpr double farDistance = 1.0e9;
+
+    constexpr int axisMargin = 40;
+}
+
+SweepHeatmapWidget::SweepHeatmapWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    setWindowTitle(tr("Launch window sweep"));
+    resize(520, 560);
+    setMouseTracking(true);
+
+    statusLabel_ = new QLabel(tr("No sweep"), this);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addStretch(1);
+    layout->addWidget(statusLabel_);
+
+    pollTimer_ = new QTimer(this);
+    pollTimer_->setInterval(100);
+    connect(pollTimer_, &QTimer::timeout, this, &SweepHeatmapWidget::pollSweep);
+}
+
+SweepHeatmapWidget::~SweepHeatmapWidget() = default;
+
+void SweepHeatmapWidget::startSweep(const SweepSpec &spec)
+{
+    // The old sweep's destructor cancels it and waits for the running cells.
+    sweep_.reset();
+
+    sweep_ = std::make_unique<LaunchWindowSweep>(spec);
+
+    const int columns = std::max(spec.speed.count, 1);
+    const int rows = std::max(spec.angleDeg.count, 1);
+
+    image_ = QImage(columns, rows, QImage::Format_RGB32);
+    image_.fill(QColor(40, 40, 40));
+    painted_.assign(static_cast<std::size_t>(columns * rows), false);
+
+    sweep_->start();
+    pollTimer_->start();
+    update();
+}
+
+void SweepHeatmapWidget::pollSweep()
+{
+    if (!sweep_)
+    {
+        return;
+    }
+
+    const SweepSpec &spec = sweep_->spec();
+    const int columns = image_.width();
+    const int rows = image_.height();
+
+    for (int a = 0; a < rows; ++a)
+    {
+        for (int s = 0; s < columns; ++s)
+        {
+            const std::size_t pixel = static_cast<std::size_t>(a * columns + s);
+            if (painted_[pixel])
+            {
+                continue;
+            }
+
+            LaunchWindowSweep::CellIndex cell;
+            cell.speed = s;
+            cell.angle = a;
+
+            const std::size_t flat = sweep_->flatIndex(cell);
+            if (!sweep_->isDone(flat))
+            {
+                continue;
+            }
+
+            // Angle grows upwards.
+            image_.setPixel(s, rows - 1 - a, colourFor(sweep_->result(flat)));
+            painted_[pixel] = true;
+        }
+    }
+
+    const std::size_t done = sweep_->completedCount();
+    const std::size_t total = sweep_->cellCount();
+
+    if (done >= total)
+    {
+        pollTimer_->stop();
+    }
+
+    statusLabel_->setText(tr("%1 / %2 cells, v0 %3..%4 km/s, angle %5..%6 deg")
+                              .arg(done)
+                              .arg(total)
+                              .arg(spec.speed.min, 0, 'f', 1)
+                              .arg(spec.speed.max, 0, 'f', 1)
+                              .arg(spec.angleDeg.min, 0, 'f', 1)
+                              .arg(spec.angleDeg.max, 0, 'f', 1));
+    update();
+}
+
+QRgb SweepHeatmapWidget::colourFor(const SweepMetrics &metrics) const
+{
+    // Log distance: close passes are hot, misses are dark blue.
+    const double d = std::clamp(metrics.minJupiterDistance, nearDistance, farDistance);
+    const double u = 1.0 - std::log10(d / nearDistance) / std::log10(farDistance / nearDistance);
+
+    const int r = static_cast<int>(255.0 * std::clamp(2.0 * u - 0.6, 0.0, 1.0));
+    const int g = static_cast<int>(255.0 * std::clamp(2.0 * u - 1.0, 0.0, 1.0));
+    const int b = static_cast<int>(255.0 * std::clamp(0.6 - std::abs(u - 0.3), 0.2, 0.6));
+
+    return qRgb(r, g, b);
+}
+
+QRect SweepHeatmapWidget::plotRect() const
+{
+    const int bottom = statusLabel_->geometry().top() - 8;
+    return QRect(axisMargin, 8, std::max(width() - axisMargin - 8, 1), std::max(bottom - 8 - axisMargin / 2, 1));
+}
+
+bool SweepHeatmapWidget::cellAt(const QPoint &pos, int &speedIndex, int &angleIndex) const
+{
+    const QRect rect = plotRect();
+    if (image_.isNull() || !rect.contains(pos))
+    {
+        return false;
+    }
+
+    speedIndex = (pos.x() - rect.left()) * image_.width() / rect.width();
+    angleIndex = image_.height() - 1 - (pos.y() - rect.top()) * image_.height() / rect.height();
+
+    speedIndex = std::clamp(speedIndex, 0, image_.width() - 1);
+    angleIndex = std::clamp(angleIndex, 0, image_.height() - 1);
+    return true;
+}
+
+void SweepHeatmapWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().window());
+
+    if (image_.isNull())
+    {
+        return;
+    }
+
+    const QRect rect = plotRect();
+    painter.drawImage(rect, image_);
+    painter.setPen(palette().text().color());
+    painter.drawRect(rect.adjusted(0, 0, -1, -1));
+
+    const SweepSpec &spec = sweep_->spec();
+    painter.drawText(QRect(rect.left(), rect.bottom() + 2, rect.width(), axisMargin / 2),
+                     Qt::AlignCenter, tr("v0 [km/s]"));
+    painter.drawText(QRect(rect.left(), rect.bottom() + 2, rect.width(), axisMargin / 2),
+                     Qt::AlignLeft, QString::number(spec.speed.min, 'f', 1));
+    painter.drawText(QRect(rect.left(), rect.bottom() + 2, rect.width(), axisMargin / 2),
+                     Qt::AlignRight, QString::number(spec.speed.max, 'f', 1));
+    painter.drawText(QRect(0, rect.top(), axisMargin - 4, 20),
+                     Qt::AlignRight, QString::number(spec.angleDeg.max, 'f', 0));
+    painter.drawText(QRect(0, rect.bottom() - 20, axisMargin - 4, 20),
+                     Qt::AlignRight | Qt::AlignBottom, QString::number(spec.angleDeg.min, 'f', 0));
+}
+
+void SweepHeatmapWidget::mousePressEvent(QMouseEvent *event)
+{
+    int s = 0;
+    int a = 0;
+    if (!sweep_ || event->button() != Qt::LeftButton || !cellAt(event->pos(), s, a))
+    {
+        return;
+    }
+
+    const SweepSpec &spec = sweep_->spec();
+    emit cellPicked(spec.speed.value(s), spec.angleDeg.value(a));
+}
+
+void SweepHeatmapWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    int s = 0;
+    int a = 0;
+    if (!sweep_ || !cellAt(event->pos(), s, a))
+    {
+        setToolTip(QString());
+        return;
+    }
+
+    LaunchWindowSweep::CellIndex cell;
+    cell.speed = s;
+    cell.angle = a;
+    const std::size_t flat = sweep_->flatIndex(cell);
+
+    const SweepSpec &spec = sweep_->spec();
+    QString text = tr("v0 %1 km/s, angle %2 deg")
+                       .arg(spec.speed.value(s), 0, 'f', 2)
+                       .arg(spec.angleDeg.value(a), 0, 'f', 2);
+
+    if (sweep_->isDone(flat))
+    {
+        const SweepMetrics &m = sweep_->result(flat);
+        text += tr("\nmin Jupiter distance %1 km\nat %2 days\nspeed after %3 km/s")
+                    .arg(m.minJupiterDistance, 0, 'g', 4)
+                    .arg(m.closestApproachTime / 86400.0, 0, 'f', 1)
+                    .arg(m.postFlybySpeed, 0, 'f', 2);
+    }
+
+    setToolTip(text);
+}
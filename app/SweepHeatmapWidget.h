@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QWidget>
+#include <QImage>
+#include <QLabel>
+#include <QTimer>
+#include <memory>
+#include "LaunchWindowSweep.h"
+
+// Porkchop-style view of a LaunchWindowSweep over launch speed (x) and launch
+// angle (y). Cells are coloured by closest approach to Jupiter as soon as the
+// pool finishes them; clicking a finished cell emits its launch parameters.
+// Only the first radius/phase/epoch slice of the sweep is shown.
+class SweepHeatmapWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SweepHeatmapWidget(QWidget *parent = nullptr);
+    ~SweepHeatmapWidget();
+
+    // Cancels any running sweep and starts a new one.
+    void startSweep(const SweepSpec &spec);
+
+signals:
+    void cellPicked(double speed, double angleDeg);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+
+private:
+    void pollSweep();
+    QRect plotRect() const;
+    bool cellAt(const QPoint &pos, int &speedIndex, int &angleIndex) const;
+    QRgb colourFor(const SweepMetrics &metrics) const;
+
+    std::unique_ptr<LaunchWindowSweep> sweep_;
+    QImage image_;
+    std::vector<bool> painted_;
+    QTimer *pollTimer_ = nullptr;
+    QLabel *statusLabel_ = nullptr;
+};
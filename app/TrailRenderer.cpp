@@ -0,0 +1,112 @@
+#include "TrailRenderer.h"
+
+#include <QPainter>
+#include <QPen>
+
+void TrailRenderer::draw(QPainter &painter,
+                         const TrajectoryBuffer &trail,
+                         const ScreenSpaceConverter &converter,
+                         const QPen &pen,
+                         double lodTolerance,
+                         const WorldRect &view)
+{
+    if (trail.empty())
+    {
+        return;
+    }
+
+    points_.clear();
+    stats_.culledSegments += trail.simplify(lodTolerance, &view, points_);
+
+    drawPoints(painter, converter, pen, view);
+}
+
+void TrailRenderer::drawAppended(QPainter &painter,
+                                 const TrajectoryBuffer &trail,
+                                 std::uint64_t fromIndex,
+                                 const ScreenSpaceConverter &converter,
+                                 const QPen &pen,
+                                 const WorldRect &view)
+{
+    const std::uint64_t end = trail.endIndex();
+
+    // Start one point early so the new part joins the already drawn one.
+    std::uint64_t begin = (fromIndex > 0) ? fromIndex - 1 : 0;
+    if (begin < trail.firstIndex())
+    {
+        begin = trail.firstIndex();
+    }
+
+    if (begin >= end)
+    {
+        return;
+    }
+
+    points_.clear();
+    for (std::uint64_t i = begin; i < end; ++i)
+    {
+        points_.push_back(trail.atIndex(i));
+    }
+
+    drawPoints(painter, converter, pen, view);
+}
+
+void TrailRenderer::drawPoints(QPainter &painter,
+                               const ScreenSpaceConverter &converter,
+                               const QPen &pen,
+                               const WorldRect &view)
+{
+    painter.setPen(pen);
+
+    screen_.resize(points_.size());
+    converter.toScreen(points_, screen_.data());
+
+    run_.clear();
+    bool hasPrev = false;
+
+    for (std::size_t i = 0; i < points_.size(); ++i)
+    {
+        const Vector2 &p = points_[i];
+
+        if (TrajectoryBuffer::isBreakPoint(p))
+        {
+            flushRun(painter);
+            hasPrev = false;
+            continue;
+        }
+
+        if (!hasPrev)
+        {
+            hasPrev = true;
+            continue;
+        }
+
+        if (view.intersectsSegment(points_[i - 1], p))
+        {
+            if (run_.empty())
+            {
+                run_.emplace_back(screen_[i - 1].x, screen_[i - 1].y);
+            }
+
+            run_.emplace_back(screen_[i].x, screen_[i].y);
+            ++stats_.drawnSegments;
+        }
+        else
+        {
+            flushRun(painter);
+            ++stats_.culledSegments;
+        }
+    }
+
+    flushRun(painter);
+}
+
+void TrailRenderer::flushRun(QPainter &painter)
+{
+    if (run_.size() >= 2)
+    {
+        painter.drawPolyline(run_.data(), static_cast<int>(run_.size()));
+    }
+
+    run_.clear();
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <QPointF>
+#include "ScreenSpaceConverter.h"
+#include "../core/WorldRect.h"
+#include "../sim/TrajectoryBuffer.h"
+
+class QPainter;
+class QPen;
+
+// Draws a trajectory as polylines, one drawPolyline call per contiguous run
+// (runs are split at TrajectoryBuffer break markers). The working arrays are
+// kept between calls, so drawing does not allocate once they have grown to
+// the size of the largest trail.
+//
+// Segments whose bounding box misses the view rectangle are culled; segments
+// crossing the view edge are kept whole so clipping is left to QPainter.
+class TrailRenderer
+{
+public:
+    struct Stats
+    {
+        std::uint64_t drawnSegments = 0;
+        std::uint64_t culledSegments = 0;
+    };
+
+    void draw(QPainter &painter,
+              const TrajectoryBuffer &trail,
+              const ScreenSpaceConverter &converter,
+              const QPen &pen,
+              double lodTolerance,
+              const WorldRect &view);
+
+    // Draws only the segments that end at points with absolute index >= fromIndex,
+    // i.e. what was appended since an earlier draw() or drawAppended() call.
+    void drawAppended(QPainter &painter,
+                      const TrajectoryBuffer &trail,
+                      std::uint64_t fromIndex,
+                      const ScreenSpaceConverter &converter,
+                      const QPen &pen,
+                      const WorldRect &view);
+
+    // Segment counts accumulated since the last resetStats().
+    const Stats& stats() const
+    {
+        return stats_;
+    }
+
+    void resetStats()
+    {
+        stats_ = Stats();
+    }
+
+private:
+    void drawPoints(QPainter &painter, const ScreenSpaceConverter &converter, const QPen &pen, const WorldRect &view);
+    void flushRun(QPainter &painter);
+
+    std::vector<Vector2> points_;     // world points of the trail being drawn
+    std::vector<ScreenPoint> screen_; // points_ mapped to the screen in one batch
+    std::vector<QPointF> run_;        // screen points of the current run
+
+    Stats stats_;
+};
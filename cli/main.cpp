@@ -0,0 +1,253 @@
+// Headless runner: runs every scenario in turn, each stepped with
+// SimulationModel::update() as fast as the CPU allows (no UI timer), and
+// prints a timing and final state report per scenario.
+//
+// Scenarios come from a scenario file (--config=FILE, io/ScenarioFile.h); without
+// one a single default scenario runs. --key=value options use the file's keys
+// and override every scenario.
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "CheckpointFile.h"
+#include "ScenarioFile.h"
+#include "TrajectoryFile.h"
+#include "SimulationModel.h"
+
+namespace
+{
+    constexpr double yearSeconds = 365.25 * 86400.0;
+
+    struct Override
+    {
+        std::string key;
+        std::string value;
+    };
+
+    void printUsage()
+    {
+        std::printf(
+            "usage: cosmic_catapult_cli [--config=FILE] [--key=value ...]\n"
+            "\n"
+            "Runs every scenario in FILE (see io/ScenarioFile.h for the format), or one\n"
+            "default scenario without it. --key=value options override every scenario.\n"
+            "\n"
+            "  --r0=AU             launch radius (1)\n"
+            "  --phi0=DEG          launch position angle (0)\n"
+            "  --v0=KM/S           launch speed (40)\n"
+            "  --fi0=DEG           launch direction (90)\n"
+            "  --dt=VALUE          step, in units of the time scale (0.1)\n"
+            "  --time-scale=S      simulated seconds per dt unit (3153600)\n"
+            "  --end=YEARS         simulated time to run (5)\n"
+            "  --epoch=S           departure epoch, see ScenarioParams (0)\n"
+            "  --integrator=NAME   rk4, euler, dp45, leapfrog, yoshida4, yoshida6, abm4, taylor (rk4)\n"
+            "  --auto-align=0|1    align the assist planet for a flyby (0)\n"
+            "  --assist-planet=N   0 = Jupiter, 1 = Earth (0)\n"
+            "  --coast=0|1         Kepler coast far from the planets (0)\n"
+            "  --body=NAME FIELDS  sun, jupiter or earth with mu=, radius=, orbit=, phase=\n"
+            "  --trail=N           trail capacity per body (5000)\n"
+            "  --output=PATH       write the ship trajectory (io/TrajectoryFile.h)\n"
+            "  --output-interval=N record every N-th step (1)\n"
+            "  --output-compress=0|1 delta-encode the trajectory (0)\n"
+            "  --output-position-quantum=KM, --output-velocity-quantum=KM/S\n"
+            "                      rounding step for compressed columns (0 = lossless)\n"
+            "  --checkpoint=PATH   save the model state here at the end (io/CheckpointFile.h)\n"
+            "  --checkpoint-interval=N  also every N steps (0)\n"
+            "  --resume=PATH       continue from a checkpoint instead of the launch state\n");
+    }
+
+    void applyBody(SimulationModel &model, const BodySpec &body)
+    {
+        if (body.name == "sun")
+        {
+            model.setSunMu(body.mu);
+            return;
+        }
+
+        const int planetIndex = (body.name == "earth") ? 1 : 0;
+        model.setPlanet(planetIndex, body.mu, body.radius, body.orbitRadius, body.phase);
+    }
+
+    void runScenario(const ScenarioSpec &spec, const std::string &resumePath)
+    {
+        const double step = spec.params.dt * spec.timeScale;
+        if (!(step > 0.0))
+        {
+            std::fprintf(stderr, "scenario '%s': dt * time-scale must be positive\n", spec.name.c_str());
+            return;
+        }
+
+        State2 initial;
+        initial.position = spec.params.shipPosition;
+        initial.velocity = spec.params.shipVelocity;
+
+        SimulationModel model(initial, MU_SUN, spec.params.dt, spec.integrator, spec.output.trailSize);
+        model.setTimeScale(spec.timeScale);
+        model.setKeplerCoast(spec.keplerCoast);
+        for (const BodySpec &body : spec.bodies)
+        {
+            applyBody(model, body);
+        }
+        model.reset(spec.params);
+
+        if (!resumePath.empty())
+        {
+            SimulationCheckpoint checkpoint;
+            if (!loadCheckpoint(resumePath, checkpoint))
+            {
+                std::fprintf(stderr, "cannot read checkpoint '%s'\n", resumePath.c_str());
+                return;
+            }
+            model.restore(checkpoint);
+        }
+
+        TrajectoryEncoding encoding;
+        if (spec.output.compress)
+        {
+            encoding.codec = TrajectoryCodec::Delta;
+            encoding.positionQuantum = spec.output.positionQuantum;
+            encoding.velocityQuantum = spec.output.velocityQuantum;
+        }
+
+        TrajectoryWriter writer(4096, encoding);
+        if (!spec.output.trajectoryPath.empty())
+        {
+            if (!writer.open(spec.output.trajectoryPath))
+            {
+                std::fprintf(stderr, "cannot write '%s'\n", spec.output.trajectoryPath.c_str());
+                return;
+            }
+            writer.append(model.time(), model.state());
+        }
+
+        std::size_t steps = 0;
+
+        const auto start = std::chrono::steady_clock::now();
+
+        while (model.time() < spec.endTime)
+        {
+            model.update();
+            ++steps;
+
+            if (writer.isOpen() && steps % static_cast<std::size_t>(spec.output.interval) == 0)
+            {
+                writer.append(model.time(), model.state());
+            }
+
+            if (spec.output.checkpointInterval > 0 && !spec.output.checkpointPath.empty()
+                && steps % spec.output.checkpointInterval == 0)
+            {
+                saveCheckpoint(spec.output.checkpointPath, model.checkpoint());
+            }
+        }
+
+        if (!spec.output.checkpointPath.empty() && !saveCheckpoint(spec.output.checkpointPath, model.checkpoint()))
+        {
+            std::fprintf(stderr, "cannot write checkpoint '%s'\n", spec.output.checkpointPath.c_str());
+        }
+
+        const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (writer.isOpen() && !writer.close())
+        {
+            std::fprintf(stderr, "error writing '%s'\n", spec.output.trajectoryPath.c_str());
+        }
+
+        const State2 &s = model.state();
+        const Vector2 toJupiter = s.position - model.jupiterPosition();
+
+        if (!spec.name.empty())
+        {
+            std::printf("scenario         %s\n", spec.name.c_str());
+        }
+        std::printf("steps            %zu\n", steps);
+        std::printf("wall time        %.6f s\n", wall);
+        std::printf("steps/s          %.0f\n", wall > 0.0 ? static_cast<double>(steps) / wall : 0.0);
+        std::printf("sim time         %.6f yr\n", model.time() / yearSeconds);
+        std::printf("position         %.6f %.6f km\n", s.position.x, s.position.y);
+        std::printf("velocity         %.9f %.9f km/s\n", s.velocity.x, s.velocity.y);
+        std::printf("radius           %.9f AU\n", radiusFromPosition(s.position) / AU_KM);
+        std::printf("speed            %.9f km/s\n", speedFromVelocity(s.velocity));
+        std::printf("jupiter distance %.6f km\n\n", radiusFromPosition(toJupiter));
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::string configPath;
+    std::string resumePath;
+    std::vector<Override> overrides;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h")
+        {
+            printUsage();
+            return 0;
+        }
+
+        const std::size_t eq = arg.find('=');
+        if (arg.rfind("--", 0) != 0 || eq == std::string::npos)
+        {
+            std::fprintf(stderr, "expected --key=value, got '%s'\n", arg.c_str());
+            return 2;
+        }
+
+        const std::string key = arg.substr(2, eq - 2);
+        const std::string value = arg.substr(eq + 1);
+
+        if (key == "config")
+        {
+            configPath = value;
+            continue;
+        }
+
+        if (key == "resume")
+        {
+            resumePath = value;
+            continue;
+        }
+
+        // Checked once here so a bad option fails before any scenario runs.
+        ScenarioSpec probe;
+        std::string message;
+        if (!ScenarioParser::applyOption(probe, key, value, message))
+        {
+            std::fprintf(stderr, "--%s: %s\n", key.c_str(), message.c_str());
+            return 2;
+        }
+
+        overrides.push_back(Override{ key, value });
+    }
+
+    ScenarioSpec run;
+    const auto runWithOverrides = [&](const ScenarioSpec &spec)
+    {
+        run = spec;
+        std::string message;
+        for (const Override &o : overrides)
+        {
+            ScenarioParser::applyOption(run, o.key, o.value, message);
+        }
+        run.resolveLaunch();
+        runScenario(run, resumePath);
+    };
+
+    if (configPath.empty())
+    {
+        runWithOverrides(ScenarioSpec());
+        return 0;
+    }
+
+    ScenarioError error;
+    if (!parseScenarioFile(configPath, runWithOverrides, &error))
+    {
+        std::fprintf(stderr, "%s:%d: %s\n", configPath.c_str(), error.line, error.message.c_str());
+        return 2;
+    }
+
+    return 0;
+}
@@ -1,10 +1,14 @@
 #pragma once
 
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
 #include "OrbitMath.h"
 #include "State2.h"
 #include "Vector2.h"
 #include "Body.h"
+#include <concepts>
 #include <functional>
 
 // Compute gravitational acceleration at a given position
@@ -48,7 +52,16 @@ inline State2 derivatives(const State2 &state, double mu)
     return result;
 }
 
-inline State2 derivatives(const State2 &state, const std::function<Vector2(const Vector2&)> &accel)
+// Acceleration models: any callable Vector2(const Vector2 &position).
+// The templated integrators below take the callable by reference so it inlines
+// into the stage computations; the std::function overloads forward to them.
+template <typename Accel>
+concept AccelerationField = std::invocable<Accel&, const Vector2&>;
+
+using AccelerationFunction = std::function<Vector2(const Vector2&)>;
+
+template <AccelerationField Accel>
+inline State2 derivatives(const State2 &state, Accel &&accel)
 {
     State2 result;
 
@@ -59,6 +72,11 @@ inline State2 derivatives(const State2 &state, const std::function<Vector2(const
     return result;
 }
 
+inline State2 derivatives(const State2 &state, const AccelerationFunction &accel)
+{
+    return derivatives<const AccelerationFunction&>(state, accel);
+}
+
 inline State2 stepEuler(const State2 &state, double dt, double mu)
 {
     State2 k = derivatives(state, mu);
@@ -72,7 +90,8 @@ inline State2 stepEuler(const State2 &state, double dt, double mu)
     return result;
 }
 
-inline State2 stepEuler(const State2 &state, double dt, const std::function<Vector2(const Vector2&)> &accel)
+template <AccelerationField Accel>
+inline State2 stepEuler(const State2 &state, double dt, Accel &&accel)
 {
     State2 k = derivatives(state, accel);
 
@@ -85,6 +104,11 @@ inline State2 stepEuler(const State2 &state, double dt, const std::function<Vect
     return result;
 }
 
+inline State2 stepEuler(const State2 &state, double dt, const AccelerationFunction &accel)
+{
+    return stepEuler<const AccelerationFunction&>(state, dt, accel);
+}
+
 inline State2 stepRK4(const State2 &state, double dt, double mu)
 {
     const State2 k1 = derivatives(state, mu);
@@ -112,7 +136,8 @@ inline State2 stepRK4(const State2 &state, double dt, double mu)
     return result;
 }
 
-inline State2 stepRK4(const State2 &state, double dt, const std::function<Vector2(const Vector2&)> &accel)
+template <AccelerationField Accel>
+inline State2 stepRK4(const State2 &state, double dt, Accel &&accel)
 {
     const State2 k1 = derivatives(state, accel);
 
@@ -139,6 +164,402 @@ inline State2 stepRK4(const State2 &state, double dt, const std::function<Vector
     return result;
 }
 
+inline State2 stepRK4(const State2 &state, double dt, const AccelerationFunction &accel)
+{
+    return stepRK4<const AccelerationFunction&>(state, dt, accel);
+}
+
+// Symplectic integrators: compositions of the drift-kick-drift leapfrog
+// (the position form of velocity Verlet). They are time-reversible and keep the
+// energy error bounded over long runs instead of letting it drift, and need one
+// acceleration evaluation per stage since consecutive half-drifts are merged.
+namespace detail
+{
+    // Runs leapfrog sub-steps of weights[i] * dt in sequence.
+    template <std::size_t N, AccelerationField Accel>
+    inline State2 composeLeapfrog(const State2 &state, double dt, const double (&weights)[N], Accel &&accel)
+    {
+        State2 s = state;
+
+        s.position = s.position + s.velocity * (0.5 * weights[0] * dt);
+
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            s.velocity = s.velocity + accel(s.position) * (weights[i] * dt);
+
+            const double drift = (i + 1 < N) ? 0.5 * (weights[i] + weights[i + 1]) : 0.5 * weights[i];
+            s.position = s.position + s.velocity * (drift * dt);
+        }
+
+        return s;
+    }
+
+    inline constexpr double yoshida4Outer = 1.3512071919596578; // 1 / (2 - 2^(1/3))
+    inline constexpr double yoshida4Inner = -1.7024143839193153; // -2^(1/3) / (2 - 2^(1/3))
+
+    // Yoshida (1990), solution A.
+    inline constexpr double yoshida6W1 = -1.17767998417887;
+    inline constexpr double yoshida6W2 = 0.235573213359357;
+    inline constexpr double yoshida6W3 = 0.784513610477560;
+    inline constexpr double yoshida6W0 = 1.0 - 2.0 * (yoshida6W1 + yoshida6W2 + yoshida6W3);
+}
+
+// Second order, one evaluation per step.
+template <AccelerationField Accel>
+inline State2 stepLeapfrog(const State2 &state, double dt, Accel &&accel)
+{
+    static constexpr double weights[] = { 1.0 };
+    return detail::composeLeapfrog(state, dt, weights, accel);
+}
+
+// Fourth order, three evaluations per step.
+template <AccelerationField Accel>
+inline State2 stepYoshida4(const State2 &state, double dt, Accel &&accel)
+{
+    static constexpr double weights[] = { detail::yoshida4Outer, detail::yoshida4Inner, detail::yoshida4Outer };
+    return detail::composeLeapfrog(state, dt, weights, accel);
+}
+
+// Sixth order, seven evaluations per step.
+template <AccelerationField Accel>
+inline State2 stepYoshida6(const State2 &state, double dt, Accel &&accel)
+{
+    static constexpr double weights[] =
+    {
+        detail::yoshida6W3, detail::yoshida6W2, detail::yoshida6W1, detail::yoshida6W0,
+        detail::yoshida6W1, detail::yoshida6W2, detail::yoshida6W3
+    };
+    return detail::composeLeapfrog(state, dt, weights, accel);
+}
+
+inline State2 stepLeapfrog(const State2 &state, double dt, const AccelerationFunction &accel)
+{
+    return stepLeapfrog<const AccelerationFunction&>(state, dt, accel);
+}
+
+inline State2 stepYoshida4(const State2 &state, double dt, const AccelerationFunction &accel)
+{
+    return stepYoshida4<const AccelerationFunction&>(state, dt, accel);
+}
+
+inline State2 stepYoshida6(const State2 &state, double dt, const AccelerationFunction &accel)
+{
+    return stepYoshida6<const AccelerationFunction&>(state, dt, accel);
+}
+
+inline State2 stepLeapfrog(const State2 &state, double dt, double mu)
+{
+    return stepLeapfrog(state, dt, [mu](const Vector2 &position) { return gravitationalAcceleration(position, mu); });
+}
+
+inline State2 stepYoshida4(const State2 &state, double dt, double mu)
+{
+    return stepYoshida4(state, dt, [mu](const Vector2 &position) { return gravitationalAcceleration(position, mu); });
+}
+
+inline State2 stepYoshida6(const State2 &state, double dt, double mu)
+{
+    return stepYoshida6(state, dt, [mu](const Vector2 &position) { return gravitationalAcceleration(position, mu); });
+}
+
+// Derivative history for the Adams-Bashforth-Moulton integrator.
+// f[0] is the derivative at the current state, f[1] one step earlier, and so on.
+struct MultistepHistory
+{
+    static constexpr int order = 4;
+
+    State2 f[order];
+    int count = 0;     // valid entries
+    double step = 0.0; // step size the history was built with
+
+    void clear()
+    {
+        count = 0;
+        step = 0.0;
+    }
+
+    void push(const State2 &derivative)
+    {
+        for (int i = order - 1; i > 0; --i)
+        {
+            f[i] = f[i - 1];
+        }
+        f[0] = derivative;
+
+        if (count < order)
+        {
+            ++count;
+        }
+    }
+};
+
+// Fourth-order Adams-Bashforth-Moulton predictor-corrector (PECE).
+//
+// Predicts with AB4 from the stored derivatives, evaluates, corrects with AM4
+// and evaluates again, so a step costs two acceleration evaluations instead of
+// RK4's four. The history starts over whenever it is empty or dt differs from
+// the step it was built with; the first three steps are then taken with RK4.
+// `state` must be the state the history ended at (clear() it after a jump).
+template <AccelerationField Accel>
+inline State2 stepAdamsBashforthMoulton4(const State2 &state, double dt, Accel &&accel, MultistepHistory &history)
+{
+    if (history.count == 0 || history.step != dt)
+    {
+        history.clear();
+        history.step = dt;
+        history.push(derivatives(state, accel));
+    }
+
+    if (history.count < MultistepHistory::order)
+    {
+        const State2 next = stepRK4(state, dt, accel);
+        history.push(derivatives(next, accel));
+        return next;
+    }
+
+    const State2 *f = history.f;
+    const double h = dt / 24.0;
+
+    State2 predicted;
+    predicted.position = state.position + (f[0].position * 55.0 - f[1].position * 59.0
+                                         + f[2].position * 37.0 - f[3].position * 9.0) * h;
+    predicted.velocity = state.velocity + (f[0].velocity * 55.0 - f[1].velocity * 59.0
+                                         + f[2].velocity * 37.0 - f[3].velocity * 9.0) * h;
+
+    const State2 fp = derivatives(predicted, accel);
+
+    State2 corrected;
+    corrected.position = state.position + (fp.position * 9.0 + f[0].position * 19.0
+                                         - f[1].position * 5.0 + f[2].position) * h;
+    corrected.velocity = state.velocity + (fp.velocity * 9.0 + f[0].velocity * 19.0
+                                         - f[1].velocity * 5.0 + f[2].velocity) * h;
+
+    history.push(derivatives(corrected, accel));
+    return corrected;
+}
+
+inline State2 stepAdamsBashforthMoulton4(const State2 &state, double dt, const AccelerationFunction &accel, MultistepHistory &history)
+{
+    return stepAdamsBashforthMoulton4<const AccelerationFunction&>(state, dt, accel, history);
+}
+
+inline State2 stepAdamsBashforthMoulton4(const State2 &state, double dt, double mu, MultistepHistory &history)
+{
+    return stepAdamsBashforthMoulton4(state, dt,
+                                      [mu](const Vector2 &position) { return gravitationalAcceleration(position, mu); },
+                                      history);
+}
+
+// Error control for the adaptive integrators. A step is accepted when the RMS of
+// (local error / (absTol + relTol * |y|)) over all state components is <= 1.
+struct AdaptiveStepOptions
+{
+    double absTol = 1e-6;     // km and km/s
+    double relTol = 1e-10;
+    double minStep = 1e-3;    // s; steps below this are accepted regardless of error
+    double maxStep = 0.0;     // s; 0 = no limit
+    double safety = 0.9;
+    double minFactor = 0.2;   // bounds on the step-size change per attempt
+    double maxFactor = 5.0;
+};
+
+struct AdaptiveStepStats
+{
+    std::uint64_t accepted = 0;
+    std::uint64_t rejected = 0;
+    std::uint64_t evaluations = 0; // acceleration evaluations
+};
+
+namespace detail
+{
+    inline State2 axpy(const State2 &y, double h, const State2 &k)
+    {
+        State2 result;
+        result.position = y.position + k.position * h;
+        result.velocity = y.velocity + k.velocity * h;
+        return result;
+    }
+
+    inline double errorTerm(double err, double y0, double y1, const AdaptiveStepOptions &options)
+    {
+        const double scale = options.absTol + options.relTol * std::max(std::fabs(y0), std::fabs(y1));
+        const double e = err / scale;
+        return e * e;
+    }
+
+    // Scaled RMS norm of the error estimate between `y0` and `y1`.
+    inline double errorNorm(const State2 &err, const State2 &y0, const State2 &y1, const AdaptiveStepOptions &options)
+    {
+        const double sum = errorTerm(err.position.x, y0.position.x, y1.position.x, options)
+                         + errorTerm(err.position.y, y0.position.y, y1.position.y, options)
+                         + errorTerm(err.velocity.x, y0.velocity.x, y1.velocity.x, options)
+                         + errorTerm(err.velocity.y, y0.velocity.y, y1.velocity.y, options);
+
+        return std::sqrt(sum * 0.25);
+    }
+}
+
+// Dormand-Prince 5(4) embedded Runge-Kutta integration over `interval` seconds.
+//
+// The interval is covered by as many internal steps as the error control needs;
+// rejected steps are retried with a smaller step. `h` is the step size to try
+// first and receives the proposed size for the next call, so passing the same
+// variable back warm-starts the controller (h <= 0 picks an initial guess).
+// The last stage of an accepted step is reused as the first stage of the next
+// one (FSAL), so an accepted step costs six acceleration evaluations.
+template <AccelerationField Accel>
+inline State2 stepDormandPrince45(const State2 &state,
+                                  double interval,
+                                  double &h,
+                                  Accel &&accel,
+                                  const AdaptiveStepOptions &options,
+                                  AdaptiveStepStats &stats)
+{
+    constexpr double a21 = 1.0 / 5.0;
+    constexpr double a31 = 3.0 / 40.0, a32 = 9.0 / 40.0;
+    constexpr double a41 = 44.0 / 45.0, a42 = -56.0 / 15.0, a43 = 32.0 / 9.0;
+    constexpr double a51 = 19372.0 / 6561.0, a52 = -25360.0 / 2187.0, a53 = 64448.0 / 6561.0, a54 = -212.0 / 729.0;
+    constexpr double a61 = 9017.0 / 3168.0, a62 = -355.0 / 33.0, a63 = 46732.0 / 5247.0, a64 = 49.0 / 176.0, a65 = -5103.0 / 18656.0;
+    constexpr double a71 = 35.0 / 384.0, a73 = 500.0 / 1113.0, a74 = 125.0 / 192.0, a75 = -2187.0 / 6784.0, a76 = 11.0 / 84.0;
+
+    // Difference between the 5th- and 4th-order weights.
+    constexpr double e1 = 71.0 / 57600.0, e3 = -71.0 / 16695.0, e4 = 71.0 / 1920.0;
+    constexpr double e5 = -17253.0 / 339200.0, e6 = 22.0 / 525.0, e7 = -1.0 / 40.0;
+
+    if (interval <= 0.0)
+    {
+        return state;
+    }
+
+    const auto f = [&](const State2 &y)
+    {
+        ++stats.evaluations;
+        return derivatives(y, accel);
+    };
+
+    State2 y = state;
+    State2 k1 = f(y);
+
+    if (!(h > 0.0))
+    {
+        // Initial guess: 1% of the time scale on which the state changes.
+        const double d0 = std::sqrt(y.position.x * y.position.x + y.position.y * y.position.y);
+        const double d1 = std::sqrt(k1.position.x * k1.position.x + k1.position.y * k1.position.y);
+        h = (d0 > 0.0 && d1 > 0.0) ? 0.01 * d0 / d1 : interval;
+    }
+
+    double remaining = interval;
+    bool lastRejected = false;
+
+    while (remaining > 0.0)
+    {
+        if (options.maxStep > 0.0)
+        {
+            h = std::min(h, options.maxStep);
+        }
+        h = std::max(h, options.minStep);
+
+        // Do not overshoot the interval; a tiny remainder is folded into this step.
+        const bool finalStep = h >= remaining * (1.0 - 1e-12);
+        const double step = finalStep ? remaining : h;
+        const bool shortened = finalStep && step < h;
+
+        const State2 k2 = f(detail::axpy(y, step * a21, k1));
+
+        State2 y3 = detail::axpy(y, step * a31, k1);
+        y3 = detail::axpy(y3, step * a32, k2);
+        const State2 k3 = f(y3);
+
+        State2 y4 = detail::axpy(y, step * a41, k1);
+        y4 = detail::axpy(y4, step * a42, k2);
+        y4 = detail::axpy(y4, step * a43, k3);
+        const State2 k4 = f(y4);
+
+        State2 y5 = detail::axpy(y, step * a51, k1);
+        y5 = detail::axpy(y5, step * a52, k2);
+        y5 = detail::axpy(y5, step * a53, k3);
+        y5 = detail::axpy(y5, step * a54, k4);
+        const State2 k5 = f(y5);
+
+        State2 y6 = detail::axpy(y, step * a61, k1);
+        y6 = detail::axpy(y6, step * a62, k2);
+        y6 = detail::axpy(y6, step * a63, k3);
+        y6 = detail::axpy(y6, step * a64, k4);
+        y6 = detail::axpy(y6, step * a65, k5);
+        const State2 k6 = f(y6);
+
+        State2 yNew = detail::axpy(y, step * a71, k1);
+        yNew = detail::axpy(yNew, step * a73, k3);
+        yNew = detail::axpy(yNew, step * a74, k4);
+        yNew = detail::axpy(yNew, step * a75, k5);
+        yNew = detail::axpy(yNew, step * a76, k6);
+        const State2 k7 = f(yNew);
+
+        State2 err;
+        err.position = (k1.position * e1 + k3.position * e3 + k4.position * e4
+                      + k5.position * e5 + k6.position * e6 + k7.position * e7) * step;
+        err.velocity = (k1.velocity * e1 + k3.velocity * e3 + k4.velocity * e4
+                      + k5.velocity * e5 + k6.velocity * e6 + k7.velocity * e7) * step;
+
+        const double norm = detail::errorNorm(err, y, yNew, options);
+
+        double factor = (norm > 0.0) ? options.safety * std::pow(norm, -0.2) : options.maxFactor;
+        factor = std::clamp(factor, options.minFactor, options.maxFactor);
+
+        if (norm <= 1.0 || step <= options.minStep)
+        {
+            ++stats.accepted;
+
+            y = yNew;
+            k1 = k7; // FSAL
+            remaining -= step;
+
+            // Never grow right after a rejection, and do not let a shortened final
+            // step shrink the proposal carried into the next call.
+            const double proposal = step * (lastRejected ? std::min(factor, 1.0) : factor);
+            if (!shortened || proposal > h)
+            {
+                h = proposal;
+            }
+            lastRejected = false;
+        }
+        else
+        {
+            ++stats.rejected;
+
+            h = step * factor;
+            lastRejected = true;
+        }
+    }
+
+    return y;
+}
+
+inline State2 stepDormandPrince45(const State2 &state,
+                                  double interval,
+                                  double &h,
+                                  const AccelerationFunction &accel,
+                                  const AdaptiveStepOptions &options,
+                                  AdaptiveStepStats &stats)
+{
+    return stepDormandPrince45<const AccelerationFunction&>(state, interval, h, accel, options, stats);
+}
+
+inline State2 stepDormandPrince45(const State2 &state,
+                                  double interval,
+                                  double &h,
+                                  double mu,
+                                  const AdaptiveStepOptions &options,
+                                  AdaptiveStepStats &stats)
+{
+    return stepDormandPrince45(state, interval, h,
+                               [mu](const Vector2 &position)
+                               {
+                                   return gravitationalAcceleration(position, mu);
+                               },
+                               options, stats);
+}
+
 inline void simulateStep(State2 &state, double dt, double mu)
 {
     state = stepRK4(state, dt, mu);
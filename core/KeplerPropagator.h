@@ -0,0 +1,323 @@
+#pragma once
+
+#include <cmath>
+#include "OrbitMath.h"
+#include "OrbitUtils.h"
+#include "State2.h"
+#include "Vector2.h"
+
+// Two-body propagation in universal variables.
+//
+// propagateKepler() advances a state around a central mass by any dt in O(1):
+// it solves the universal Kepler equation for the universal anomaly chi with
+// Newton's method and maps the initial state with the Lagrange f and g
+// coefficients. The same formulas hold for elliptic, parabolic and hyperbolic
+// orbits, with the Stumpff functions C(z) and S(z) covering all three.
+
+// Stumpff function C(z) = (1 - cos(sqrt z)) / z, continued for z <= 0.
+inline double stumpffC(double z)
+{
+    if (z > 1e-3)
+    {
+        return (1.0 - std::cos(std::sqrt(z))) / z;
+    }
+
+    if (z < -1e-3)
+    {
+        return (std::cosh(std::sqrt(-z)) - 1.0) / (-z);
+    }
+
+    // Series near zero, where the closed forms cancel.
+    return 1.0 / 2.0 - z / 24.0 + z * z / 720.0 - z * z * z / 40320.0 + z * z * z * z / 3628800.0;
+}
+
+// Stumpff function S(z) = (sqrt z - sin(sqrt z)) / sqrt(z)^3, continued for z <= 0.
+inline double stumpffS(double z)
+{
+    if (z > 1e-3)
+    {
+        const double sz = std::sqrt(z);
+        return (sz - std::sin(sz)) / (sz * sz * sz);
+    }
+
+    if (z < -1e-3)
+    {
+        const double sz = std::sqrt(-z);
+        return (std::sinh(sz) - sz) / (sz * sz * sz);
+    }
+
+    return 1.0 / 6.0 - z / 120.0 + z * z / 5040.0 - z * z * z / 362880.0 + z * z * z * z / 39916800.0;
+}
+
+struct KeplerSolveInfo
+{
+    int iterations = 0;
+    bool converged = false;
+};
+
+inline State2 propagateKepler(const State2 &state, double mu, double dt, KeplerSolveInfo *info = nullptr)
+{
+    const double pi = 3.14159265358979323846;
+
+    const Vector2 &r0v = state.position;
+    const Vector2 &v0v = state.velocity;
+
+    const double r0 = radiusFromPosition(r0v);
+    const double v0 = speedFromVelocity(v0v);
+
+    if (mu <= 0.0 || r0 == 0.0 || dt == 0.0)
+    {
+        if (info)
+        {
+            info->converged = (dt == 0.0);
+        }
+        return (mu <= 0.0 && r0 != 0.0) ? State2{ r0v + v0v * dt, v0v } : state;
+    }
+
+    const double sqrtMu = std::sqrt(mu);
+    const double rv = dot(r0v, v0v);
+    const double alpha = 2.0 / r0 - v0 * v0 / mu; // 1 / semi-major axis
+
+    // On an ellipse only the time modulo the period matters; this keeps chi small.
+    double t = dt;
+    if (alpha * r0 > 1e-9)
+    {
+        const double period = 2.0 * pi / (sqrtMu * alpha * std::sqrt(alpha));
+        t = std::fmod(dt, period);
+    }
+
+    // Initial guesses after Vallado, "Fundamentals of Astrodynamics", algorithm 8.
+    double chi;
+    if (alpha * r0 > 1e-9)
+    {
+        chi = sqrtMu * t * alpha;
+    }
+    else if (alpha * r0 < -1e-9)
+    {
+        const double a = 1.0 / alpha;
+        const double sign = (t > 0.0) ? 1.0 : -1.0;
+        const double argument = (-2.0 * mu * alpha * t)
+                              / (rv + sign * std::sqrt(-mu * a) * (1.0 - r0 * alpha));
+        chi = (argument > 0.0) ? sign * std::sqrt(-a) * std::log(argument) : sqrtMu * t / r0;
+    }
+    else
+    {
+        const double h = crossZ(r0v, v0v);
+        const double p = h * h / mu;
+
+        if (p > 0.0)
+        {
+            const double s = 0.5 * std::atan(1.0 / (3.0 * std::sqrt(mu / (p * p * p)) * t));
+            const double w = std::atan(std::cbrt(std::tan(s)));
+            chi = std::sqrt(p) * 2.0 / std::tan(2.0 * w);
+        }
+        else
+        {
+            chi = sqrtMu * t / r0;
+        }
+    }
+
+    // Newton iteration on the universal Kepler equation F(chi) = 0.
+    const double rvOverSqrtMu = rv / sqrtMu;
+    const double oneMinusAlphaR0 = 1.0 - alpha * r0;
+
+    double c = 0.0;
+    double s = 0.0;
+    int iterations = 0;
+    bool converged = false;
+
+    for (; iterations < 50; ++iterations)
+    {
+        const double chi2 = chi * chi;
+        const double z = alpha * chi2;
+        c = stumpffC(z);
+        s = stumpffS(z);
+
+        const double f = rvOverSqrtMu * chi2 * c + oneMinusAlphaR0 * chi2 * chi * s + r0 * chi - sqrtMu * t;
+        const double df = rvOverSqrtMu * chi * (1.0 - z * s) + oneMinusAlphaR0 * chi2 * c + r0; // = r(chi)
+
+        if (df == 0.0)
+        {
+            break;
+        }
+
+        const double delta = f / df;
+        chi -= delta;
+
+        if (std::fabs(delta) <= 1e-13 * (1.0 + std::fabs(chi)))
+        {
+            converged = true;
+            const double z1 = alpha * chi * chi;
+            c = stumpffC(z1);
+            s = stumpffS(z1);
+            ++iterations;
+            break;
+        }
+    }
+
+    if (info)
+    {
+        info->iterations = iterations;
+        info->converged = converged;
+    }
+
+    // Lagrange coefficients.
+    const double chi2 = chi * chi;
+    const double f = 1.0 - chi2 / r0 * c;
+    const double g = t - chi2 * chi / sqrtMu * s;
+
+    State2 result;
+    result.position = r0v * f + v0v * g;
+
+    const double r = radiusFromPosition(result.position);
+    const double fDot = sqrtMu / (r * r0) * (alpha * chi2 * chi * s - chi);
+    const double gDot = 1.0 - chi2 / r * c;
+
+    result.velocity = r0v * fDot + v0v * gDot;
+
+    return result;
+}
+
+// Time since periapsis at true anomaly nu on a conic with eccentricity e and
+// semi-latus rectum p (negative before periapsis).
+inline double timeSincePeriapsis(double nu, double e, double p, double mu)
+{
+    const double halfTan = std::tan(0.5 * nu);
+
+    if (e < 1.0 - 1e-9)
+    {
+        const double a = p / (1.0 - e * e);
+        const double eccentricAnomaly = 2.0 * std::atan(std::sqrt((1.0 - e) / (1.0 + e)) * halfTan);
+        const double meanAnomaly = eccentricAnomaly - e * std::sin(eccentricAnomaly);
+        return meanAnomaly * std::sqrt(a * a * a / mu);
+    }
+
+    if (e > 1.0 + 1e-9)
+    {
+        const double a = p / (e * e - 1.0);
+        const double hyperbolicAnomaly = 2.0 * std::atanh(std::sqrt((e - 1.0) / (e + 1.0)) * halfTan);
+        const double meanAnomaly = e * std::sinh(hyperbolicAnomaly) - hyperbolicAnomaly;
+        return meanAnomaly * std::sqrt(a * a * a / mu);
+    }
+
+    // Barker's equation.
+    return 0.5 * std::sqrt(p * p * p / mu) * (halfTan + halfTan * halfTan * halfTan / 3.0);
+}
+
+// First time t > 0 at which the two-body orbit through `state` reaches radius
+// `targetRadius`, or a negative value if it never does within `maxTime`.
+//
+// The crossing is found on the conic: the true anomalies at the target radius
+// follow from r = p / (1 + e cos nu), the first one ahead of the current
+// anomaly is picked, and Kepler's equation gives the time of flight. A few
+// bracketed Newton steps on |r(t)| with propagateKepler() then polish the
+// result to the accuracy of the propagator.
+inline double timeToRadius(const State2 &state, double mu, double targetRadius, double maxTime)
+{
+    const double pi = 3.14159265358979323846;
+
+    const OrbitState orbit = makeOrbitState(state.position, state.velocity, mu);
+    const double e = orbit.eccentricity;
+    const double p = orbit.angularMomentum * orbit.angularMomentum / mu;
+
+    if (!(mu > 0.0) || !(p > 0.0) || !(targetRadius > 0.0) || e < 1e-12)
+    {
+        return -1.0;
+    }
+
+    // cos(nu) at the target radius; outside [-1, 1] the orbit never gets there.
+    const double cosTarget = (p / targetRadius - 1.0) / e;
+    if (cosTarget < -1.0 || cosTarget > 1.0)
+    {
+        return -1.0;
+    }
+
+    const double nuTarget = std::acos(cosTarget);
+
+    // True anomaly in (-pi, pi]; negative while falling towards periapsis.
+    const double nu0 = (dot(state.position, state.velocity) < 0.0) ? -orbit.trueAnomaly : orbit.trueAnomaly;
+    const double t0 = timeSincePeriapsis(nu0, e, p, mu);
+
+    double tof = -1.0;
+
+    const double candidates[] = { -nuTarget, nuTarget };
+
+    for (const double nu : candidates)
+    {
+        // Open orbits only reach anomalies below the asymptote.
+        if (e >= 1.0 && std::fabs(nu) >= pi)
+        {
+            continue;
+        }
+
+        double t = timeSincePeriapsis(nu, e, p, mu) - t0;
+
+        if (t <= 0.0 && e < 1.0)
+        {
+            const double a = p / (1.0 - e * e);
+            t += 2.0 * pi * std::sqrt(a * a * a / mu);
+        }
+
+        if (t > 0.0 && (tof < 0.0 || t < tof))
+        {
+            tof = t;
+        }
+    }
+
+    if (tof < 0.0)
+    {
+        return -1.0;
+    }
+
+    // Polish: Newton on g(t) = |r(t)| - targetRadius with dg/dt = r.v / |r|,
+    // kept inside a bracket around the analytic estimate.
+    double lo = tof * (1.0 - 1e-6);
+    double hi = tof * (1.0 + 1e-6);
+
+    const auto g = [&](double t)
+    {
+        return radiusFromPosition(propagateKepler(state, mu, t).position) - targetRadius;
+    };
+
+    double gLo = g(lo);
+    const double gHi = g(hi);
+
+    if ((gLo < 0.0) != (gHi < 0.0))
+    {
+        double t = tof;
+
+        for (int i = 0; i < 8; ++i)
+        {
+            const State2 s = propagateKepler(state, mu, t);
+            const double r = radiusFromPosition(s.position);
+            const double gt = r - targetRadius;
+
+            if (std::fabs(gt) <= 1e-12 * targetRadius)
+            {
+                break;
+            }
+
+            if ((gt < 0.0) == (gLo < 0.0))
+            {
+                lo = t;
+                gLo = gt;
+            }
+            else
+            {
+                hi = t;
+            }
+
+            const double rate = dot(s.position, s.velocity) / r;
+            double next = (rate != 0.0) ? t - gt / rate : 0.5 * (lo + hi);
+            if (!(next > lo && next < hi))
+            {
+                next = 0.5 * (lo + hi);
+            }
+            t = next;
+        }
+
+        tof = t;
+    }
+
+    return (tof <= maxTime) ? tof : -1.0;
+}
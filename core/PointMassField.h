@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include "OrbitMath.h"
+#include "Vector2.h"
+#include "Body.h"
+
+// Gravity of a few point masses held fixed during a step.
+// Callable like any acceleration function, but also exposes its sources so
+// integrators that need the structure of the field (stepTaylor) can use them.
+struct PointMassField
+{
+    struct Source
+    {
+        Vector2 position;
+        double mu = 0.0;
+    };
+
+    static constexpr std::size_t maxSources = 4;
+
+    Source sources[maxSources];
+    std::size_t count = 0;
+
+    void add(const Vector2 &position, double mu)
+    {
+        if (count < maxSources)
+        {
+            sources[count].position = position;
+            sources[count].mu = mu;
+            ++count;
+        }
+    }
+
+    void add(const Body &body)
+    {
+        add(body.position, body.mu);
+    }
+
+    Vector2 operator()(const Vector2 &position) const
+    {
+        Vector2 result(0.0, 0.0);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const Vector2 r = position - sources[i].position;
+            const double dist = radiusFromPosition(r);
+
+            if (dist == 0.0)
+            {
+                continue;
+            }
+
+            const double factor = -sources[i].mu / (dist * dist * dist);
+            result = result + Vector2(factor * r.x, factor * r.y);
+        }
+
+        return result;
+    }
+};
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "Dynamics.h"
+#include "PointMassField.h"
+#include "State2.h"
+
+// High-order Taylor series integrator for a PointMassField.
+//
+// The Taylor coefficients of the trajectory are generated by automatic
+// differentiation of the inverse-cube law: for each source, d = x - p,
+// s = |d|^2 and u = s^(-3/2) are expanded with the product and power rules,
+// and x^(n+2) follows from the acceleration -mu * d * u. One step costs
+// O(order^2) per source, but near machine precision the step can be many times
+// longer than an RK4 step.
+//
+// Order and step size are chosen as in Jorba & Zou (2005): the order from the
+// tolerance, the step from the last two coefficients.
+struct TaylorOptions
+{
+    double tolerance = 1e-15; // relative to the size of the state
+    int minOrder = 8;
+    int maxOrder = 30;
+    double maxStep = 0.0;     // s; 0 = no limit
+};
+
+namespace detail
+{
+    inline constexpr int taylorMaxOrder = 40;
+
+    inline int taylorOrder(const TaylorOptions &options)
+    {
+        const double tol = std::max(options.tolerance, 1e-20);
+        const int order = static_cast<int>(std::ceil(-0.5 * std::log(tol) + 1.0));
+        const int upper = std::min(options.maxOrder, taylorMaxOrder);
+
+        return std::clamp(order, std::min(options.minOrder, upper), upper);
+    }
+
+    // Fills cx/cy[0..order] with the normalized Taylor coefficients of the position.
+    inline void taylorCoefficients(const State2 &state, const PointMassField &field, int order, double *cx, double *cy)
+    {
+        constexpr double exponent = -1.5;
+
+        double dx[PointMassField::maxSources][taylorMaxOrder + 1];
+        double dy[PointMassField::maxSources][taylorMaxOrder + 1];
+        double s[PointMassField::maxSources][taylorMaxOrder + 1];
+        double u[PointMassField::maxSources][taylorMaxOrder + 1];
+
+        cx[0] = state.position.x;
+        cy[0] = state.position.y;
+        cx[1] = state.velocity.x;
+        cy[1] = state.velocity.y;
+
+        for (int n = 0; n + 2 <= order; ++n)
+        {
+            double ax = 0.0;
+            double ay = 0.0;
+
+            for (std::size_t b = 0; b < field.count; ++b)
+            {
+                const PointMassField::Source &src = field.sources[b];
+
+                dx[b][n] = (n == 0) ? cx[0] - src.position.x : cx[n];
+                dy[b][n] = (n == 0) ? cy[0] - src.position.y : cy[n];
+
+                double sn = 0.0;
+                for (int i = 0; i <= n; ++i)
+                {
+                    sn += dx[b][i] * dx[b][n - i] + dy[b][i] * dy[b][n - i];
+                }
+                s[b][n] = sn;
+
+                const double s0 = s[b][0];
+                if (s0 == 0.0)
+                {
+                    continue;
+                }
+
+                if (n == 0)
+                {
+                    u[b][0] = 1.0 / (s0 * std::sqrt(s0));
+                }
+                else
+                {
+                    // Power rule for u = s^exponent.
+                    double sum = 0.0;
+                    for (int i = 0; i < n; ++i)
+                    {
+                        sum += (exponent * (n - i) - i) * s[b][n - i] * u[b][i];
+                    }
+                    u[b][n] = sum / (n * s0);
+                }
+
+                double px = 0.0;
+                double py = 0.0;
+                for (int i = 0; i <= n; ++i)
+                {
+                    px += dx[b][i] * u[b][n - i];
+                    py += dy[b][i] * u[b][n - i];
+                }
+
+                ax -= src.mu * px;
+                ay -= src.mu * py;
+            }
+
+            const double scale = 1.0 / (static_cast<double>(n + 1) * static_cast<double>(n + 2));
+            cx[n + 2] = ax * scale;
+            cy[n + 2] = ay * scale;
+        }
+    }
+}
+
+inline State2 stepTaylor(const State2 &state,
+                         double interval,
+                         const PointMassField &field,
+                         const TaylorOptions &options,
+                         AdaptiveStepStats &stats)
+{
+    if (interval <= 0.0)
+    {
+        return state;
+    }
+
+    const int order = detail::taylorOrder(options);
+
+    double cx[detail::taylorMaxOrder + 1];
+    double cy[detail::taylorMaxOrder + 1];
+
+    State2 y = state;
+    double remaining = interval;
+
+    while (remaining > 0.0)
+    {
+        detail::taylorCoefficients(y, field, order, cx, cy);
+        ++stats.evaluations;
+
+        // Radius of convergence estimated from the last two coefficients,
+        // relative to the size of the position.
+        const double size = std::max(std::fabs(cx[0]), std::fabs(cy[0]));
+        const double last1 = std::max(std::fabs(cx[order - 1]), std::fabs(cy[order - 1]));
+        const double last0 = std::max(std::fabs(cx[order]), std::fabs(cy[order]));
+
+        double rho = std::numeric_limits<double>::infinity();
+        if (size > 0.0 && last1 > 0.0)
+        {
+            rho = std::min(rho, std::pow(size / last1, 1.0 / (order - 1)));
+        }
+        if (size > 0.0 && last0 > 0.0)
+        {
+            rho = std::min(rho, std::pow(size / last0, 1.0 / order));
+        }
+
+        double h = rho * std::exp(-2.0 - 0.7 / (order - 1));
+        if (options.maxStep > 0.0)
+        {
+            h = std::min(h, options.maxStep);
+        }
+        if (h >= remaining * (1.0 - 1e-12) || !(h > 0.0))
+        {
+            h = remaining;
+        }
+
+        // Horner evaluation of the series and its derivative.
+        double px = cx[order];
+        double py = cy[order];
+        double vx = order * cx[order];
+        double vy = order * cy[order];
+
+        for (int j = order - 1; j >= 1; --j)
+        {
+            px = px * h + cx[j];
+            py = py * h + cy[j];
+            vx = vx * h + j * cx[j];
+            vy = vy * h + j * cy[j];
+        }
+
+        y.position = Vector2(px * h + cx[0], py * h + cy[0]);
+        y.velocity = Vector2(vx, vy);
+
+        ++stats.accepted;
+        remaining -= h;
+    }
+
+    return y;
+}
+
+inline State2 stepTaylor(const State2 &state, double interval, double mu, const TaylorOptions &options, AdaptiveStepStats &stats)
+{
+    PointMassField field;
+    field.add(Vector2(0.0, 0.0), mu);
+
+    return stepTaylor(state, interval, field, options, stats);
+}
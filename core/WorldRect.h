@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Vector2.h"
+
+// Axis-aligned rectangle in world coordinates.
+struct WorldRect
+{
+    Vector2 min;
+    Vector2 max;
+
+    bool intersects(const Vector2 &boxMin, const Vector2 &boxMax) const
+    {
+        return boxMin.x <= max.x && boxMax.x >= min.x &&
+               boxMin.y <= max.y && boxMax.y >= min.y;
+    }
+
+    // Whether the bounding box of segment a-b touches the rectangle. This is
+    // conservative: a segment passing near a corner may be reported as touching.
+    bool intersectsSegment(const Vector2 &a, const Vector2 &b) const
+    {
+        const Vector2 boxMin(a.x < b.x ? a.x : b.x, a.y < b.y ? a.y : b.y);
+        const Vector2 boxMax(a.x > b.x ? a.x : b.x, a.y > b.y ? a.y : b.y);
+        return intersects(boxMin, boxMax);
+    }
+
+    WorldRect expanded(double margin) const
+    {
+        WorldRect result;
+        result.min = Vector2(min.x - margin, min.y - margin);
+        result.max = Vector2(max.x + margin, max.y + margin);
+        return result;
+    }
+};
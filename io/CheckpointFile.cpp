@@ -0,0 +1,357 @@
+#include "CheckpointFile.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+namespace
+{
+    constexpr char checkpointMagic[8] = { 'C', 'C', 'C', 'H', 'K', 'P', 'T', 0 };
+    constexpr std::uint32_t checkpointVersion = 2;
+    constexpr std::uint32_t flagTrails = 1;
+
+    constexpr std::size_t headerSize = sizeof(checkpointMagic) + 2 * sizeof(std::uint32_t) + sizeof(std::uint64_t);
+
+    class BlobWriter
+    {
+    public:
+        explicit BlobWriter(std::vector<unsigned char> &out) : out_(out)
+        {
+        }
+
+        template <typename T>
+        void raw(const T &value)
+        {
+            const auto *bytes = reinterpret_cast<const unsigned char*>(&value);
+            out_.insert(out_.end(), bytes, bytes + sizeof(T));
+        }
+
+        void f64(double v) { raw(v); }
+        void u64(std::uint64_t v) { raw(v); }
+        void u32(std::uint32_t v) { raw(v); }
+
+        void vec(const Vector2 &v)
+        {
+            f64(v.x);
+            f64(v.y);
+        }
+
+        void state(const State2 &s)
+        {
+            vec(s.position);
+            vec(s.velocity);
+        }
+
+        void body(const Body &b)
+        {
+            f64(b.mass);
+            f64(b.radius);
+            f64(b.mu);
+            vec(b.position);
+            vec(b.velocity);
+        }
+
+        void points(const std::vector<Vector2> &points)
+        {
+            u64(points.size());
+            const auto *bytes = reinterpret_cast<const unsigned char*>(points.data());
+            out_.insert(out_.end(), bytes, bytes + points.size() * sizeof(Vector2));
+        }
+
+    private:
+        std::vector<unsigned char> &out_;
+    };
+
+    // Reads past the end set `ok` to false and yield zeros.
+    class BlobReader
+    {
+    public:
+        BlobReader(const unsigned char *data, std::size_t size) : p_(data), end_(data + size)
+        {
+        }
+
+        template <typename T>
+        T raw()
+        {
+            T value{};
+            if (static_cast<std::size_t>(end_ - p_) < sizeof(T))
+            {
+                ok = false;
+                p_ = end_;
+                return value;
+            }
+            std::memcpy(&value, p_, sizeof(T));
+            p_ += sizeof(T);
+            return value;
+        }
+
+        double f64() { return raw<double>(); }
+        std::uint64_t u64() { return raw<std::uint64_t>(); }
+        std::uint32_t u32() { return raw<std::uint32_t>(); }
+
+        Vector2 vec()
+        {
+            const double x = f64();
+            const double y = f64();
+            return Vector2(x, y);
+        }
+
+        State2 state()
+        {
+            State2 s;
+            s.position = vec();
+            s.velocity = vec();
+            return s;
+        }
+
+        Body body()
+        {
+            Body b;
+            b.mass = f64();
+            b.radius = f64();
+            b.mu = f64();
+            b.position = vec();
+            b.velocity = vec();
+            return b;
+        }
+
+        void points(std::vector<Vector2> &points)
+        {
+            const std::uint64_t count = u64();
+            if (count > static_cast<std::size_t>(end_ - p_) / sizeof(Vector2))
+            {
+                ok = false;
+                p_ = end_;
+                return;
+            }
+            points.resize(static_cast<std::size_t>(count));
+            std::memcpy(points.data(), p_, points.size() * sizeof(Vector2));
+            p_ += points.size() * sizeof(Vector2);
+        }
+
+        bool ok = true;
+
+    private:
+        const unsigned char *p_;
+        const unsigned char *end_;
+    };
+}
+
+void encodeCheckpoint(const SimulationCheckpoint &c, std::vector<unsigned char> &out)
+{
+    const std::size_t start = out.size();
+    BlobWriter w(out);
+
+    out.insert(out.end(), checkpointMagic, checkpointMagic + sizeof(checkpointMagic));
+    w.u32(checkpointVersion);
+    w.u32(c.hasTrails ? flagTrails : 0);
+    w.u64(0); // body size, patched below
+
+    const ControllerCheckpoint &k = c.controller;
+    w.state(k.state);
+    w.f64(k.mu);
+    w.f64(k.dt);
+    w.u32(static_cast<std::uint32_t>(k.integrator));
+
+    w.f64(k.adaptiveOptions.absTol);
+    w.f64(k.adaptiveOptions.relTol);
+    w.f64(k.adaptiveOptions.minStep);
+    w.f64(k.adaptiveOptions.maxStep);
+    w.f64(k.adaptiveOptions.safety);
+    w.f64(k.adaptiveOptions.minFactor);
+    w.f64(k.adaptiveOptions.maxFactor);
+
+    w.u64(k.adaptiveStats.accepted);
+    w.u64(k.adaptiveStats.rejected);
+    w.u64(k.adaptiveStats.evaluations);
+
+    w.f64(k.taylorOptions.tolerance);
+    w.u32(static_cast<std::uint32_t>(k.taylorOptions.minOrder));
+    w.u32(static_cast<std::uint32_t>(k.taylorOptions.maxOrder));
+    w.f64(k.taylorOptions.maxStep);
+
+    w.f64(k.adaptiveStep);
+    for (const State2 &f : k.history.f)
+    {
+        w.state(f);
+    }
+    w.u32(static_cast<std::uint32_t>(k.history.count));
+    w.f64(k.history.step);
+
+    w.u32(k.keplerCoast ? 1 : 0);
+    w.f64(k.coastThreshold);
+    w.u32(k.coasting ? 1 : 0);
+
+    w.f64(c.time);
+    w.f64(c.timeScale);
+    w.body(c.sun);
+    w.body(c.jupiter);
+    w.body(c.earth);
+
+    w.f64(c.jupiterAngle);
+    w.f64(c.jupiterOrbitRadius);
+    w.f64(c.jupiterAngularSpeed);
+    w.f64(c.jupiterPhase);
+    w.f64(c.earthAngle);
+    w.f64(c.earthOrbitRadius);
+    w.f64(c.earthAngularSpeed);
+    w.f64(c.earthPhase);
+
+    w.u32(c.trailBreakPending ? 1 : 0);
+
+    if (c.hasTrails)
+    {
+        w.points(c.shipTrail);
+        w.points(c.jupiterTrail);
+        w.points(c.earthTrail);
+    }
+
+    const std::uint64_t bodySize = out.size() - start - headerSize;
+    std::memcpy(out.data() + start + headerSize - sizeof(bodySize), &bodySize, sizeof(bodySize));
+}
+
+bool decodeCheckpoint(const unsigned char *data, std::size_t size, SimulationCheckpoint &c)
+{
+    if (size < headerSize || std::memcmp(data, checkpointMagic, sizeof(checkpointMagic)) != 0)
+    {
+        return false;
+    }
+
+    BlobReader r(data + sizeof(checkpointMagic), size - sizeof(checkpointMagic));
+    const std::uint32_t version = r.u32();
+    const std::uint32_t flags = r.u32();
+    const std::uint64_t bodySize = r.u64();
+
+    if (version != checkpointVersion || bodySize > size - headerSize)
+    {
+        return false;
+    }
+
+    r = BlobReader(data + headerSize, static_cast<std::size_t>(bodySize));
+
+    ControllerCheckpoint &k = c.controller;
+    k.state = r.state();
+    k.mu = r.f64();
+    k.dt = r.f64();
+
+    // Taylor is the last IntegratorType.
+    const std::uint32_t integrator = r.u32();
+    if (integrator > static_cast<std::uint32_t>(IntegratorType::Taylor))
+    {
+        return false;
+    }
+    k.integrator = static_cast<IntegratorType>(integrator);
+
+    k.adaptiveOptions.absTol = r.f64();
+    k.adaptiveOptions.relTol = r.f64();
+    k.adaptiveOptions.minStep = r.f64();
+    k.adaptiveOptions.maxStep = r.f64();
+    k.adaptiveOptions.safety = r.f64();
+    k.adaptiveOptions.minFactor = r.f64();
+    k.adaptiveOptions.maxFactor = r.f64();
+
+    k.adaptiveStats.accepted = r.u64();
+    k.adaptiveStats.rejected = r.u64();
+    k.adaptiveStats.evaluations = r.u64();
+
+    k.taylorOptions.tolerance = r.f64();
+    k.taylorOptions.minOrder = static_cast<int>(r.u32());
+    k.taylorOptions.maxOrder = static_cast<int>(r.u32());
+    k.taylorOptions.maxStep = r.f64();
+
+    k.adaptiveStep = r.f64();
+    for (State2 &f : k.history.f)
+    {
+        f = r.state();
+    }
+    k.history.count = static_cast<int>(r.u32());
+    k.history.step = r.f64();
+
+    k.keplerCoast = r.u32() != 0;
+    k.coastThreshold = r.f64();
+    k.coasting = r.u32() != 0;
+
+    c.time = r.f64();
+    c.timeScale = r.f64();
+    c.sun = r.body();
+    c.jupiter = r.body();
+    c.earth = r.body();
+
+    c.jupiterAngle = r.f64();
+    c.jupiterOrbitRadius = r.f64();
+    c.jupiterAngularSpeed = r.f64();
+    c.jupiterPhase = r.f64();
+    c.earthAngle = r.f64();
+    c.earthOrbitRadius = r.f64();
+    c.earthAngularSpeed = r.f64();
+    c.earthPhase = r.f64();
+
+    c.trailBreakPending = r.u32() != 0;
+
+    c.hasTrails = (flags & flagTrails) != 0;
+    if (c.hasTrails)
+    {
+        r.points(c.shipTrail);
+        r.points(c.jupiterTrail);
+        r.points(c.earthTrail);
+    }
+    else
+    {
+        c.shipTrail.clear();
+        c.jupiterTrail.clear();
+        c.earthTrail.clear();
+    }
+
+    return r.ok && k.history.count >= 0 && k.history.count <= MultistepHistory::order;
+}
+
+bool saveCheckpoint(const std::string &path, const SimulationCheckpoint &checkpoint)
+{
+    std::vector<unsigned char> blob;
+    encodeCheckpoint(checkpoint, blob);
+
+    const std::string tmpPath = path + ".tmp";
+
+    std::FILE *file = std::fopen(tmpPath.c_str(), "wb");
+    if (!file)
+    {
+        return false;
+    }
+
+    bool ok = std::fwrite(blob.data(), 1, blob.size(), file) == blob.size();
+    ok = (std::fclose(file) == 0) && ok;
+
+    std::error_code error;
+    if (ok)
+    {
+        std::filesystem::rename(tmpPath, path, error);
+    }
+    if (!ok || error)
+    {
+        std::filesystem::remove(tmpPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool loadCheckpoint(const std::string &path, SimulationCheckpoint &checkpoint)
+{
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (!file)
+    {
+        return false;
+    }
+
+    std::vector<unsigned char> blob;
+    unsigned char buffer[64 * 1024];
+    std::size_t n = 0;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        blob.insert(blob.end(), buffer, buffer + n);
+    }
+    std::fclose(file);
+
+    return decodeCheckpoint(blob.data(), blob.size(), checkpoint);
+}
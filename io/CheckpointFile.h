@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "SimulationModel.h"
+
+// Binary SimulationCheckpoint blob
+//
+//   magic "CCCHKPT\0", u32 version, u32 flags (bit 0: trails), u64 body size
+//   body: every SimulationCheckpoint field in declaration order, as doubles,
+//         u64 counters and u32 enums/flags, then with trails three
+//         (u64 count, count * 2 doubles) lists.
+//
+// Fields are written one by one in native byte order, so the layout does not
+// depend on struct padding.
+
+void encodeCheckpoint(const SimulationCheckpoint &checkpoint, std::vector<unsigned char> &out);
+
+// Returns false if the blob is truncated or not a checkpoint.
+bool decodeCheckpoint(const unsigned char *data, std::size_t size, SimulationCheckpoint &checkpoint);
+
+// Writes to "<path>.tmp" and renames it over `path`, so a crash while saving
+// leaves the previous checkpoint intact.
+bool saveCheckpoint(const std::string &path, const SimulationCheckpoint &checkpoint);
+bool loadCheckpoint(const std::string &path, SimulationCheckpoint &checkpoint);
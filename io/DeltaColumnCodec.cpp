@@ -0,0 +1,218 @@
+#include "DeltaColumnCodec.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+    constexpr std::uint64_t signBit = std::uint64_t(1) << 63;
+    constexpr std::size_t blockSize = 128;
+    constexpr std::size_t blockPadding = 8;
+
+    // Monotonic map from doubles to unsigned integers (negative values reversed).
+    std::uint64_t toOrdered(double value)
+    {
+        const std::uint64_t bits = std::bit_cast<std::uint64_t>(value);
+        return (bits & signBit) ? ~bits : (bits | signBit);
+    }
+
+    double fromOrdered(std::uint64_t ordered)
+    {
+        const std::uint64_t bits = (ordered & signBit) ? (ordered & ~signBit) : ~ordered;
+        return std::bit_cast<double>(bits);
+    }
+
+    std::uint64_t zigzag(std::uint64_t residual)
+    {
+        return (residual << 1) ^ static_cast<std::uint64_t>(static_cast<std::int64_t>(residual) >> 63);
+    }
+
+    std::uint64_t unzigzag(std::uint64_t encoded)
+    {
+        return (encoded >> 1) ^ (~(encoded & 1) + 1);
+    }
+
+    std::uint64_t load64(const unsigned char *p)
+    {
+        std::uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    // Block layout: one byte with the bit width w of the widest residual, then
+    // the residuals packed LSB-first at w bits each. Every value can then be
+    // read with one unaligned 8-byte load (two if w > 57); the column ends with
+    // blockPadding zero bytes so the loads never leave the buffer.
+    void putBlock(const std::uint64_t *residuals, std::size_t count, std::vector<unsigned char> &out)
+    {
+        std::uint64_t all = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            all |= residuals[i];
+        }
+
+        const int width = 64 - std::countl_zero(all);
+        out.push_back(static_cast<unsigned char>(width));
+
+        if (width == 0)
+        {
+            return;
+        }
+
+        std::uint64_t acc = 0;
+        int bits = 0;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const std::uint64_t v = residuals[i];
+            acc |= v << bits;
+
+            if (bits + width >= 64)
+            {
+                for (int b = 0; b < 8; ++b)
+                {
+                    out.push_back(static_cast<unsigned char>(acc >> (8 * b)));
+                }
+                // Bits of v that did not fit.
+                acc = (bits == 0) ? 0 : (v >> (64 - bits));
+                bits = bits + width - 64;
+            }
+            else
+            {
+                bits += width;
+            }
+        }
+
+        for (; bits > 0; bits -= 8)
+        {
+            out.push_back(static_cast<unsigned char>(acc));
+            acc >>= 8;
+        }
+    }
+
+    // Residuals of o[i] - (2 o[i-1] - o[i-2]) in wrapping arithmetic, with
+    // o[-1] = o[-2] = 0 and o[0] standing in for o[-1] at i == 1.
+    template <typename ToInteger>
+    void encodeIntegers(std::span<const double> values, ToInteger toInteger, std::vector<unsigned char> &out)
+    {
+        std::uint64_t residuals[blockSize];
+
+        std::uint64_t prev1 = 0;
+        std::uint64_t prev2 = 0;
+
+        for (std::size_t start = 0; start < values.size(); start += blockSize)
+        {
+            const std::size_t count = std::min(blockSize, values.size() - start);
+
+            for (std::size_t j = 0; j < count; ++j)
+            {
+                const std::uint64_t o = toInteger(values[start + j]);
+                residuals[j] = zigzag(o - (2 * prev1 - prev2));
+
+                prev2 = (start + j == 0) ? o : prev1;
+                prev1 = o;
+            }
+
+            putBlock(residuals, count, out);
+        }
+
+        out.insert(out.end(), blockPadding, 0);
+    }
+
+    template <typename FromInteger>
+    bool decodeIntegers(const unsigned char *data, std::size_t size, std::size_t count, FromInteger fromInteger, double *out)
+    {
+        if (size < blockPadding)
+        {
+            return count == 0;
+        }
+
+        const unsigned char *p = data;
+        const unsigned char *end = data + size - blockPadding;
+
+        std::uint64_t prev1 = 0;
+        std::uint64_t prev2 = 0;
+
+        for (std::size_t start = 0; start < count; start += blockSize)
+        {
+            const std::size_t n = std::min(blockSize, count - start);
+
+            if (p == end)
+            {
+                return false;
+            }
+
+            const int width = *p++;
+            const std::size_t bytes = (n * static_cast<std::size_t>(width) + 7) / 8;
+            if (width > 64 || static_cast<std::size_t>(end - p) < bytes)
+            {
+                return false;
+            }
+
+            const std::uint64_t mask = (width == 64) ? ~std::uint64_t(0) : ((std::uint64_t(1) << width) - 1);
+
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                std::uint64_t v = 0;
+                if (width != 0)
+                {
+                    const std::size_t bit = j * static_cast<std::size_t>(width);
+                    const int shift = static_cast<int>(bit & 7);
+                    v = load64(p + (bit >> 3)) >> shift;
+                    if (shift + width > 64)
+                    {
+                        v |= static_cast<std::uint64_t>(p[(bit >> 3) + 8]) << (64 - shift);
+                    }
+                    v &= mask;
+                }
+
+                const std::uint64_t o = unzigzag(v) + (2 * prev1 - prev2);
+                out[start + j] = fromInteger(o);
+
+                prev2 = (start + j == 0) ? o : prev1;
+                prev1 = o;
+            }
+
+            p += bytes;
+        }
+        return true;
+    }
+}
+
+bool encodeDeltaColumn(std::span<const double> values, double quantum, std::vector<unsigned char> &out)
+{
+    if (quantum <= 0.0)
+    {
+        encodeIntegers(values, toOrdered, out);
+        return true;
+    }
+
+    // |value / quantum| must fit an int64 with room for the prediction.
+    const double limit = 0x1p61;
+    for (double v : values)
+    {
+        if (!(std::abs(v / quantum) < limit))
+        {
+            return false;
+        }
+    }
+
+    const double scale = 1.0 / quantum;
+    encodeIntegers(values, [scale](double v) { return static_cast<std::uint64_t>(std::llround(v * scale)); }, out);
+    return true;
+}
+
+bool decodeDeltaColumn(const unsigned char *data, std::size_t size, std::size_t count, double quantum, double *out)
+{
+    if (quantum <= 0.0)
+    {
+        return decodeIntegers(data, size, count, fromOrdered, out);
+    }
+
+    return decodeIntegers(data, size, count,
+                          [quantum](std::uint64_t q) { return static_cast<double>(static_cast<std::int64_t>(q)) * quantum; },
+                          out);
+}
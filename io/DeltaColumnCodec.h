@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+// Column codec for smooth sequences (trajectory samples).
+//
+// Each value is mapped to a 64-bit integer, predicted linearly from the two
+// previous ones (second-order delta), and the residual is zig-zag encoded and
+// bit-packed in blocks of 128 at the width of the block's largest residual.
+// On a smooth orbit the residuals are a few bits wide, and fixed-width blocks
+// decode without per-byte branches.
+//
+// quantum == 0: lossless. The integer is the IEEE bit pattern in an order-
+// preserving form, so decoding is bit-exact; inside one binade it is linear in
+// the value, so prediction works except for a few samples where the exponent
+// changes (e.g. near zero crossings).
+// quantum > 0: values are rounded to multiples of quantum, which makes the
+// residuals much smaller. The error is at most quantum/2 plus the double
+// rounding of value * (1/quantum) on the way in and of multiple * quantum on
+// the way out (a few ulps of the value).
+//
+// A column depends on nothing outside its own bytes, so chunks decode
+// independently.
+
+// Appends the encoding of `values` to `out`. Returns false (and appends
+// nothing) if quantum > 0 and a value is not finite or too large for it.
+bool encodeDeltaColumn(std::span<const double> values, double quantum, std::vector<unsigned char> &out);
+
+// Decodes `count` values into `out`. Returns false if `size` bytes run out first.
+bool decodeDeltaColumn(const unsigned char *data, std::size_t size, std::size_t count, double quantum, double *out);
@@ -0,0 +1,470 @@
+#include "ScenarioFile.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <utility>
+#include "SimulationModel.h"
+#include "../core/MathUtils.h"
+
+namespace
+{
+    constexpr double yearSeconds = 365.25 * 86400.0;
+
+    struct Unit
+    {
+        std::string_view suffix;
+        double scale;
+    };
+
+    constexpr Unit lengthUnits[] = { { "km", 1.0 }, { "AU", AU_KM } };
+    constexpr Unit timeUnits[] = { { "s", 1.0 }, { "h", 3600.0 }, { "d", 86400.0 }, { "yr", yearSeconds } };
+    constexpr Unit speedUnits[] = { { "km/s", 1.0 } };
+    constexpr Unit angleUnits[] = { { "rad", 1.0 }, { "deg", math::deg2rad(1.0) } };
+
+    // A '#' starts a comment at the start of a line or after whitespace, so
+    // values such as "runs/#3.traj" keep theirs.
+    std::string_view stripComment(std::string_view line)
+    {
+        for (std::size_t i = line.find('#'); i != std::string_view::npos; i = line.find('#', i + 1))
+        {
+            if (i == 0 || line[i - 1] == ' ' || line[i - 1] == '\t')
+            {
+                return line.substr(0, i);
+            }
+        }
+        return line;
+    }
+
+    std::string_view trim(std::string_view text)
+    {
+        const std::size_t first = text.find_first_not_of(" \t\r");
+        if (first == std::string_view::npos)
+        {
+            return std::string_view();
+        }
+        const std::size_t last = text.find_last_not_of(" \t\r");
+        return text.substr(first, last - first + 1);
+    }
+
+    // Splits off the next whitespace-separated token.
+    std::string_view nextToken(std::string_view &text)
+    {
+        text = trim(text);
+        const std::size_t end = text.find_first_of(" \t");
+        const std::string_view token = text.substr(0, end);
+        text = (end == std::string_view::npos) ? std::string_view() : text.substr(end);
+        return token;
+    }
+
+    bool parseNumber(std::string_view text, double &value)
+    {
+        const char *end = text.data() + text.size();
+        const auto result = std::from_chars(text.data(), end, value);
+        return !text.empty() && result.ec == std::errc() && result.ptr == end;
+    }
+
+    // Number with an optional unit suffix; without one, `defaultScale` applies.
+    template <std::size_t N>
+    bool parseQuantity(std::string_view text, const Unit (&units)[N], double defaultScale, double &value)
+    {
+        text = trim(text);
+
+        const char *end = text.data() + text.size();
+        const auto result = std::from_chars(text.data(), end, value);
+        if (text.empty() || result.ec != std::errc())
+        {
+            return false;
+        }
+
+        const std::string_view suffix = trim(std::string_view(result.ptr, static_cast<std::size_t>(end - result.ptr)));
+        if (suffix.empty())
+        {
+            value *= defaultScale;
+            return true;
+        }
+
+        for (const Unit &unit : units)
+        {
+            if (suffix == unit.suffix)
+            {
+                value *= unit.scale;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool parseBool(std::string_view text, bool &value)
+    {
+        if (text == "1" || text == "true" || text == "on")
+        {
+            value = true;
+            return true;
+        }
+        if (text == "0" || text == "false" || text == "off")
+        {
+            value = false;
+            return true;
+        }
+        return false;
+    }
+
+    template <typename Int>
+    bool parseCount(std::string_view text, Int &value)
+    {
+        const char *end = text.data() + text.size();
+        const auto result = std::from_chars(text.data(), end, value);
+        return !text.empty() && result.ec == std::errc() && result.ptr == end;
+    }
+
+    bool parseIntegrator(std::string_view name, IntegratorType &type)
+    {
+        struct Entry
+        {
+            std::string_view name;
+            IntegratorType type;
+        };
+
+        static constexpr Entry entries[] = {
+            { "rk4", IntegratorType::RK4 },
+            { "euler", IntegratorType::Euler },
+            { "dp45", IntegratorType::DormandPrince45 },
+            { "leapfrog", IntegratorType::Leapfrog },
+            { "yoshida4", IntegratorType::Yoshida4 },
+            { "yoshida6", IntegratorType::Yoshida6 },
+            { "abm4", IntegratorType::AdamsBashforthMoulton4 },
+            { "taylor", IntegratorType::Taylor },
+        };
+
+        for (const Entry &entry : entries)
+        {
+            if (name == entry.name)
+            {
+                type = entry.type;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // "x y", each with an optional unit.
+    template <std::size_t N>
+    bool parseVector(std::string_view text, const Unit (&units)[N], Vector2 &v)
+    {
+        const std::string_view x = nextToken(text);
+        const std::string_view y = nextToken(text);
+        return trim(text).empty() && parseQuantity(x, units, 1.0, v.x) && parseQuantity(y, units, 1.0, v.y);
+    }
+
+    // A polar value that was not given keeps that component of `v`.
+    void applyPolar(Vector2 &v, double &radius, double &angle)
+    {
+        if (std::isnan(radius) && std::isnan(angle))
+        {
+            return;
+        }
+
+        const double r = std::isnan(radius) ? std::sqrt(v.x * v.x + v.y * v.y) : radius;
+        const double a = std::isnan(angle) ? std::atan2(v.y, v.x) : angle;
+        v = Vector2(r * std::cos(a), r * std::sin(a));
+
+        radius = std::numeric_limits<double>::quiet_NaN();
+        angle = std::numeric_limits<double>::quiet_NaN();
+    }
+
+    bool parseBody(std::string_view text, BodySpec &body, std::string &message)
+    {
+        const std::string_view name = nextToken(text);
+        if (name.empty() || name.find('=') != std::string_view::npos)
+        {
+            message = "body needs a name first";
+            return false;
+        }
+        body.name.assign(name);
+
+        for (std::string_view field = nextToken(text); !field.empty(); field = nextToken(text))
+        {
+            const std::size_t eq = field.find('=');
+            const std::string_view key = field.substr(0, eq);
+            const std::string_view value = (eq == std::string_view::npos) ? std::string_view() : field.substr(eq + 1);
+
+            bool ok = false;
+            if (key == "mu") { ok = parseNumber(value, body.mu); }
+            else if (key == "radius") { ok = parseQuantity(value, lengthUnits, 1.0, body.radius); }
+            else if (key == "orbit") { ok = parseQuantity(value, lengthUnits, 1.0, body.orbitRadius); }
+            else if (key == "phase") { ok = parseQuantity(value, angleUnits, angleUnits[1].scale, body.phase); }
+
+            if (!ok)
+            {
+                message = "bad body field '" + std::string(field) + "'";
+                return false;
+            }
+        }
+
+        // The model has these three bodies; the Sun stays at the origin.
+        if (body.name == "sun")
+        {
+            if (body.orbitRadius != 0.0 || body.phase != 0.0)
+            {
+                message = "the sun has no orbit";
+                return false;
+            }
+        }
+        else if (body.name != "jupiter" && body.name != "earth")
+        {
+            message = "unknown body '" + body.name + "' (sun, jupiter or earth)";
+            return false;
+        }
+        return true;
+    }
+}
+
+ScenarioSpec::ScenarioSpec()
+{
+    // Same launch as the GUI defaults.
+    params.shipPosition = Vector2(AU_KM, 0.0);
+    params.shipVelocity = Vector2(0.0, 40.0);
+    endTime = 5.0 * yearSeconds;
+}
+
+void ScenarioSpec::resolveLaunch()
+{
+    applyPolar(params.shipPosition, launchRadius, launchAngle);
+    applyPolar(params.shipVelocity, launchSpeed, launchDirection);
+}
+
+ScenarioParser::ScenarioParser(Handler handler)
+    : handler_(std::move(handler))
+{
+}
+
+const ScenarioError& ScenarioParser::error() const
+{
+    return error_;
+}
+
+std::size_t ScenarioParser::scenarioCount() const
+{
+    return scenarioCount_;
+}
+
+bool ScenarioParser::feed(std::string_view text)
+{
+    if (failed_)
+    {
+        return false;
+    }
+
+    std::size_t newline = text.find('\n');
+    while (newline != std::string_view::npos)
+    {
+        std::string_view line = text.substr(0, newline);
+        text.remove_prefix(newline + 1);
+
+        // A line split across chunks is the only thing copied.
+        if (!partialLine_.empty())
+        {
+            partialLine_.append(line);
+            line = partialLine_;
+        }
+
+        const bool ok = parseLine(line);
+        partialLine_.clear();
+        if (!ok)
+        {
+            return false;
+        }
+
+        newline = text.find('\n');
+    }
+
+    partialLine_.append(text);
+    return true;
+}
+
+bool ScenarioParser::finish()
+{
+    if (failed_)
+    {
+        return false;
+    }
+
+    if (!partialLine_.empty())
+    {
+        const bool ok = parseLine(partialLine_);
+        partialLine_.clear();
+        if (!ok)
+        {
+            return false;
+        }
+    }
+
+    if (!inSection_)
+    {
+        current_ = defaults_;
+    }
+    emitCurrent();
+    inSection_ = false;
+    return true;
+}
+
+bool ScenarioParser::parseLine(std::string_view line)
+{
+    ++line_;
+
+    line = trim(stripComment(line));
+    if (line.empty())
+    {
+        return true;
+    }
+
+    if (line.front() == '[')
+    {
+        if (line.back() != ']')
+        {
+            return fail("missing ']'");
+        }
+
+        std::string_view header = line.substr(1, line.size() - 2);
+        if (nextToken(header) != "scenario")
+        {
+            return fail("expected [scenario NAME]");
+        }
+
+        if (inSection_)
+        {
+            emitCurrent();
+        }
+
+        current_ = defaults_;
+        current_.name.assign(trim(header));
+        inSection_ = true;
+        return true;
+    }
+
+    const std::size_t eq = line.find('=');
+    if (eq == std::string_view::npos)
+    {
+        return fail("expected key = value");
+    }
+
+    std::string message;
+    if (!applyOption(inSection_ ? current_ : defaults_, trim(line.substr(0, eq)), trim(line.substr(eq + 1)), message))
+    {
+        return fail(std::move(message));
+    }
+    return true;
+}
+
+bool ScenarioParser::fail(std::string message)
+{
+    failed_ = true;
+    error_.line = line_;
+    error_.message = std::move(message);
+    return false;
+}
+
+void ScenarioParser::emitCurrent()
+{
+    ++scenarioCount_;
+    current_.resolveLaunch();
+    if (handler_)
+    {
+        handler_(current_);
+    }
+}
+
+bool ScenarioParser::applyOption(ScenarioSpec &spec, std::string_view key, std::string_view value, std::string &message)
+{
+    bool ok = false;
+
+    if (key == "r0") { ok = parseQuantity(value, lengthUnits, AU_KM, spec.launchRadius); }
+    else if (key == "phi0") { ok = parseQuantity(value, angleUnits, angleUnits[1].scale, spec.launchAngle); }
+    else if (key == "v0") { ok = parseQuantity(value, speedUnits, 1.0, spec.launchSpeed); }
+    else if (key == "fi0") { ok = parseQuantity(value, angleUnits, angleUnits[1].scale, spec.launchDirection); }
+    else if (key == "position") { ok = parseVector(value, lengthUnits, spec.params.shipPosition); }
+    else if (key == "velocity") { ok = parseVector(value, speedUnits, spec.params.shipVelocity); }
+    else if (key == "dt") { ok = parseNumber(value, spec.params.dt); }
+    else if (key == "time-scale") { ok = parseQuantity(value, timeUnits, 1.0, spec.timeScale); }
+    else if (key == "end") { ok = parseQuantity(value, timeUnits, yearSeconds, spec.endTime); }
+    else if (key == "epoch") { ok = parseQuantity(value, timeUnits, 1.0, spec.params.startEpoch); }
+    else if (key == "integrator") { ok = parseIntegrator(value, spec.integrator); }
+    else if (key == "auto-align") { ok = parseBool(value, spec.params.autoAlignPlanetForAssist); }
+    else if (key == "assist-planet") { ok = parseCount(value, spec.params.assistPlanetIndex); }
+    else if (key == "clear-trails") { ok = parseBool(value, spec.params.clearTrajectoriesOnReset); }
+    else if (key == "coast") { ok = parseBool(value, spec.keplerCoast); }
+    else if (key == "trail") { ok = parseCount(value, spec.output.trailSize) && spec.output.trailSize > 0; }
+    else if (key == "output") { spec.output.trajectoryPath.assign(value); ok = true; }
+    else if (key == "output-interval") { ok = parseCount(value, spec.output.interval) && spec.output.interval > 0; }
+    else if (key == "checkpoint") { spec.output.checkpointPath.assign(value); ok = true; }
+    else if (key == "checkpoint-interval") { ok = parseCount(value, spec.output.checkpointInterval); }
+    else if (key == "output-compress") { ok = parseBool(value, spec.output.compress); }
+    else if (key == "output-position-quantum") { ok = parseQuantity(value, lengthUnits, 1.0, spec.output.positionQuantum); }
+    else if (key == "output-velocity-quantum") { ok = parseQuantity(value, speedUnits, 1.0, spec.output.velocityQuantum); }
+    else if (key == "body")
+    {
+        spec.bodies.emplace_back();
+        if (!parseBody(value, spec.bodies.back(), message))
+        {
+            spec.bodies.pop_back();
+            return false;
+        }
+        return true;
+    }
+    else
+    {
+        message = "unknown key '" + std::string(key) + "'";
+        return false;
+    }
+
+    if (!ok)
+    {
+        message = "bad value '" + std::string(value) + "' for '" + std::string(key) + "'";
+    }
+    return ok;
+}
+
+bool parseScenarioFile(const std::string &path, const ScenarioParser::Handler &handler, ScenarioError *error)
+{
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (!file)
+    {
+        if (error)
+        {
+            error->line = 0;
+            error->message = "cannot open '" + path + "'";
+        }
+        return false;
+    }
+
+    ScenarioParser parser(handler);
+
+    std::vector<char> buffer(64 * 1024);
+    bool ok = true;
+
+    while (ok)
+    {
+        const std::size_t n = std::fread(buffer.data(), 1, buffer.size(), file);
+        if (n == 0)
+        {
+            break;
+        }
+        ok = parser.feed(std::string_view(buffer.data(), n));
+    }
+
+    std::fclose(file);
+
+    ok = ok && parser.finish();
+    if (!ok && error)
+    {
+        *error = parser.error();
+    }
+    return ok;
+}
+
+bool loadScenarioFile(const std::string &path, std::vector<ScenarioSpec> &scenarios, ScenarioError *error)
+{
+    return parseScenarioFile(path, [&scenarios](const ScenarioSpec &spec) { scenarios.push_back(spec); }, error);
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ScenarioParams.h"
+#include "SimulationController.h"
+
+// Scenario text format
+//
+//   # comment (to end of line; '#' only starts one after whitespace)
+//   integrator = dp45          # keys before the first section are defaults
+//   end = 3 yr
+//
+//   [scenario fast-flyby]      # every section starts from the defaults
+//   v0 = 42
+//   fi0 = 88.5
+//   body = jupiter mu=1.26686534e8 radius=71492 orbit=5.204AU phase=0
+//
+// One "key = value" per line. Keys are the cosmic_catapult_cli options:
+//
+//   r0 = AU          phi0 = deg       v0 = km/s        fi0 = deg
+//   position = x y   (km)            velocity = vx vy (km/s)
+//   dt, time-scale = s, end = yr, epoch = s
+//   integrator = rk4 | euler | dp45 | leapfrog | yoshida4 | yoshida6 | abm4 | taylor
+//   auto-align, assist-planet, clear-trails, coast
+//   trail = points per trail, output = trajectory path, output-interval = steps
+//   output-compress, output-position-quantum = km, output-velocity-quantum = km/s
+//   checkpoint = path, checkpoint-interval = steps (0 = at the end only)
+//   body = sun|jupiter|earth [mu=km3/s2] [radius=km] [orbit=km] [phase=deg]
+//          (omitted fields keep the built-in values; see SimulationModel::setPlanet())
+//
+// r0 and phi0 replace the radius and angle of position (v0 and fi0 those of
+// velocity), whatever order the keys come in.
+//
+// Quantities take an optional unit suffix that overrides the default shown
+// above: km, AU; km/s; s, h, d, yr; deg, rad. Booleans are 0/1, true/false, on/off.
+// A file without sections is one scenario.
+
+struct BodySpec
+{
+    std::string name;
+    double mu = 0.0;           // gravitational parameter [km^3/s^2]; 0 = built-in
+    double radius = 0.0;       // physical radius [km]; 0 = built-in
+    double orbitRadius = 0.0;  // circular orbit around the Sun [km]; 0 = built-in
+    double phase = 0.0;        // orbit angle at epoch 0 [rad]
+};
+
+struct OutputSpec
+{
+    std::string trajectoryPath;  // empty = no trajectory file
+    int interval = 1;            // record every N-th step
+    std::size_t trailSize = 5000;
+    bool compress = false;       // delta codec, see DeltaColumnCodec.h
+    double positionQuantum = 0.0; // [km], 0 = lossless
+    double velocityQuantum = 0.0; // [km/s], 0 = lossless
+
+    std::string checkpointPath;  // empty = no checkpoints, see CheckpointFile.h
+    std::size_t checkpointInterval = 0; // steps between checkpoints; 0 = at the end only
+};
+
+struct ScenarioSpec
+{
+    ScenarioSpec();
+
+    std::string name;
+    ScenarioParams params;
+    IntegratorType integrator = IntegratorType::RK4;
+    double timeScale = 3153600.0;
+    double endTime = 0.0;        // [s]
+    bool keplerCoast = false;
+    std::vector<BodySpec> bodies;
+    OutputSpec output;
+
+    // r0, phi0, v0 and fi0 as given [km, rad, km/s, rad]; NaN = not given.
+    double launchRadius = std::numeric_limits<double>::quiet_NaN();
+    double launchAngle = std::numeric_limits<double>::quiet_NaN();
+    double launchSpeed = std::numeric_limits<double>::quiet_NaN();
+    double launchDirection = std::numeric_limits<double>::quiet_NaN();
+
+    // Builds params.shipPosition/shipVelocity from the polar values above and
+    // clears them. The parser calls it before handing a scenario out; call it
+    // again after applying more options.
+    void resolveLaunch();
+};
+
+struct ScenarioError
+{
+    int line = 0;                // 0 = not tied to a line
+    std::string message;
+};
+
+// Single-pass parser for the format above. Text can be fed in chunks split at
+// any byte; each scenario is handed to the handler as soon as its section ends,
+// so a file is never held in memory. The spec passed to the handler is reused
+// for the next scenario (copy it to keep it).
+class ScenarioParser
+{
+public:
+    using Handler = std::function<void(const ScenarioSpec&)>;
+
+    explicit ScenarioParser(Handler handler);
+
+    // Both return false on the first error; see error().
+    bool feed(std::string_view text);
+    bool finish();
+
+    const ScenarioError& error() const;
+    std::size_t scenarioCount() const;
+
+    // Applies one key = value pair; on failure returns false and sets `message`.
+    static bool applyOption(ScenarioSpec &spec, std::string_view key, std::string_view value, std::string &message);
+
+private:
+    bool parseLine(std::string_view line);
+    bool fail(std::string message);
+    void emitCurrent();
+
+    Handler handler_;
+    ScenarioSpec defaults_;
+    ScenarioSpec current_;
+    bool inSection_ = false;
+    bool sawKey_ = false;
+    bool failed_ = false;
+
+    std::string partialLine_;
+    int line_ = 0;
+    std::size_t scenarioCount_ = 0;
+    ScenarioError error_;
+};
+
+bool parseScenarioFile(const std::string &path, const ScenarioParser::Handler &handler, ScenarioError *error = nullptr);
+
+// Convenience wrapper that keeps every scenario.
+bool loadScenarioFile(const std::string &path, std::vector<ScenarioSpec> &scenarios, ScenarioError *error = nullptr);
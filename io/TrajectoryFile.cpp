@@ -0,0 +1,637 @@
+#include "TrajectoryFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include "DeltaColumnCodec.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    enum Column
+    {
+        ColumnT,
+        ColumnX,
+        ColumnY,
+        ColumnVx,
+        ColumnVy
+    };
+
+    // Maps the whole file read-only; returns nullptr on failure or for an empty file.
+    const unsigned char* mapFile(const std::string &path, std::size_t &size)
+    {
+        size = 0;
+
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return nullptr;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return nullptr;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping)
+        {
+            return nullptr;
+        }
+
+        // The view keeps the mapping object alive.
+        void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (!view)
+        {
+            return nullptr;
+        }
+
+        size = static_cast<std::size_t>(fileSize.QuadPart);
+        return static_cast<const unsigned char*>(view);
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || info.st_size == 0)
+        {
+            ::close(fd);
+            return nullptr;
+        }
+
+        void *view = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED)
+        {
+            return nullptr;
+        }
+
+        size = static_cast<std::size_t>(info.st_size);
+        return static_cast<const unsigned char*>(view);
+#endif
+    }
+
+    void unmapFile(const unsigned char *data, std::size_t size)
+    {
+#ifdef _WIN32
+        (void)size;
+        UnmapViewOfFile(data);
+#else
+        ::munmap(const_cast<unsigned char*>(data), size);
+#endif
+    }
+}
+
+// ---------------------------------------------------------------------------
+// TrajectoryWriter
+
+TrajectoryWriter::TrajectoryWriter(std::size_t chunkSamples, const TrajectoryEncoding &encoding)
+    : chunkSamples_(chunkSamples > 0 ? chunkSamples : 1),
+      encoding_(encoding)
+{
+}
+
+TrajectoryWriter::~TrajectoryWriter()
+{
+    close();
+}
+
+bool TrajectoryWriter::open(const std::string &path)
+{
+    close();
+
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_)
+    {
+        return false;
+    }
+
+    failed_ = false;
+    sampleCount_ = 0;
+    index_.clear();
+
+    for (std::vector<double> &column : columns_)
+    {
+        column.clear();
+        column.reserve(chunkSamples_);
+    }
+
+    TrajectoryFileHeader header{};
+    std::memcpy(header.magic, trajectoryFileMagic, sizeof(header.magic));
+    header.version = trajectoryFileVersion;
+    header.headerSize = sizeof(TrajectoryFileHeader);
+    header.chunkSamples = static_cast<std::uint32_t>(chunkSamples_);
+    header.columnCount = trajectoryColumnCount;
+
+    failed_ = std::fwrite(&header, sizeof(header), 1, file_) != 1;
+    offset_ = sizeof(header);
+    return !failed_;
+}
+
+bool TrajectoryWriter::append(double time, const State2 &state)
+{
+    if (!file_ || failed_)
+    {
+        return false;
+    }
+
+    columns_[ColumnT].push_back(time);
+    columns_[ColumnX].push_back(state.position.x);
+    columns_[ColumnY].push_back(state.position.y);
+    columns_[ColumnVx].push_back(state.velocity.x);
+    columns_[ColumnVy].push_back(state.velocity.y);
+
+    if (columns_[ColumnT].size() >= chunkSamples_)
+    {
+        return writeChunk();
+    }
+    return true;
+}
+
+bool TrajectoryWriter::writeChunk()
+{
+    const std::size_t count = columns_[ColumnT].size();
+    if (count == 0)
+    {
+        return !failed_;
+    }
+
+    TrajectoryChunkHeader header{};
+    header.magic = trajectoryChunkMagic;
+    header.codec = static_cast<std::uint32_t>(encoding_.codec);
+    header.count = static_cast<std::uint32_t>(count);
+
+    const std::vector<double> &t = columns_[ColumnT];
+    header.tMin = t.front();
+    header.tMax = t.back();
+
+    const auto [xMin, xMax] = std::minmax_element(columns_[ColumnX].begin(), columns_[ColumnX].end());
+    const auto [yMin, yMax] = std::minmax_element(columns_[ColumnY].begin(), columns_[ColumnY].end());
+    header.xMin = *xMin;
+    header.xMax = *xMax;
+    header.yMin = *yMin;
+    header.yMax = *yMax;
+
+    if (encoding_.codec == TrajectoryCodec::Delta)
+    {
+        const double quanta[trajectoryColumnCount] = {
+            encoding_.timeQuantum,
+            encoding_.positionQuantum,
+            encoding_.positionQuantum,
+            encoding_.velocityQuantum,
+            encoding_.velocityQuantum
+        };
+
+        encoded_.clear();
+
+        for (std::size_t c = 0; c < trajectoryColumnCount; ++c)
+        {
+            const std::size_t headerAt = encoded_.size();
+            encoded_.resize(headerAt + sizeof(TrajectoryColumnHeader));
+
+            // A column that does not fit the quantum (e.g. NaN) is kept lossless.
+            TrajectoryColumnHeader column{ quanta[c], 0 };
+            if (!encodeDeltaColumn(columns_[c], column.quantum, encoded_))
+            {
+                column.quantum = 0.0;
+                encodeDeltaColumn(columns_[c], column.quantum, encoded_);
+            }
+
+            column.size = encoded_.size() - headerAt - sizeof(TrajectoryColumnHeader);
+            std::memcpy(encoded_.data() + headerAt, &column, sizeof(column));
+            encoded_.resize((encoded_.size() + 7) & ~std::size_t(7), 0);
+        }
+
+        header.payloadSize = encoded_.size();
+
+        failed_ = failed_ || std::fwrite(&header, sizeof(header), 1, file_) != 1;
+        failed_ = failed_ || std::fwrite(encoded_.data(), 1, encoded_.size(), file_) != encoded_.size();
+    }
+    else
+    {
+        header.payloadSize = count * trajectoryColumnCount * sizeof(double);
+
+        failed_ = failed_ || std::fwrite(&header, sizeof(header), 1, file_) != 1;
+        for (const std::vector<double> &column : columns_)
+        {
+            failed_ = failed_ || std::fwrite(column.data(), sizeof(double), count, file_) != count;
+        }
+    }
+
+    index_.push_back(TrajectoryIndexEntry{ offset_, sampleCount_, header.tMin, header.tMax });
+
+    offset_ += sizeof(header) + header.payloadSize;
+    sampleCount_ += count;
+
+    for (std::vector<double> &column : columns_)
+    {
+        column.clear();
+    }
+
+    return !failed_;
+}
+
+bool TrajectoryWriter::flush()
+{
+    if (!file_)
+    {
+        return false;
+    }
+
+    writeChunk();
+    failed_ = failed_ || std::fflush(file_) != 0;
+    return !failed_;
+}
+
+bool TrajectoryWriter::close()
+{
+    if (!file_)
+    {
+        return false;
+    }
+
+    writeChunk();
+
+    TrajectoryFileTrailer trailer{};
+    trailer.indexOffset = offset_;
+    trailer.chunkCount = index_.size();
+    trailer.sampleCount = sampleCount_;
+    std::memcpy(trailer.magic, trajectoryFileMagic, sizeof(trailer.magic));
+
+    if (!index_.empty())
+    {
+        failed_ = failed_ || std::fwrite(index_.data(), sizeof(TrajectoryIndexEntry), index_.size(), file_) != index_.size();
+    }
+    failed_ = failed_ || std::fwrite(&trailer, sizeof(trailer), 1, file_) != 1;
+    failed_ = (std::fclose(file_) != 0) || failed_;
+    file_ = nullptr;
+
+    return !failed_;
+}
+
+bool TrajectoryWriter::isOpen() const
+{
+    return file_ != nullptr;
+}
+
+std::uint64_t TrajectoryWriter::sampleCount() const
+{
+    return sampleCount_ + columns_[ColumnT].size();
+}
+
+// ---------------------------------------------------------------------------
+// TrajectoryReader
+
+TrajectoryReader::~TrajectoryReader()
+{
+    close();
+}
+
+bool TrajectoryReader::open(const std::string &path)
+{
+    close();
+
+    data_ = mapFile(path, size_);
+    if (!data_)
+    {
+        return false;
+    }
+
+    TrajectoryFileHeader header;
+    if (size_ < sizeof(header))
+    {
+        close();
+        return false;
+    }
+
+    std::memcpy(&header, data_, sizeof(header));
+    if (std::memcmp(header.magic, trajectoryFileMagic, sizeof(header.magic)) != 0
+        || header.version != trajectoryFileVersion
+        || header.headerSize < sizeof(header)
+        || header.columnCount != trajectoryColumnCount)
+    {
+        close();
+        return false;
+    }
+
+    hasIndex_ = readIndex();
+    if (!hasIndex_)
+    {
+        scanChunks();
+    }
+    return true;
+}
+
+void TrajectoryReader::close()
+{
+    if (data_)
+    {
+        unmapFile(data_, size_);
+    }
+
+    data_ = nullptr;
+    size_ = 0;
+    chunks_.clear();
+    sampleCount_ = 0;
+    hasIndex_ = false;
+
+    cachedChunk_ = static_cast<std::size_t>(-1);
+    cachedView_ = Chunk();
+}
+
+bool TrajectoryReader::readIndex()
+{
+    TrajectoryFileTrailer trailer;
+    if (size_ < sizeof(TrajectoryFileHeader) + sizeof(trailer))
+    {
+        return false;
+    }
+
+    std::memcpy(&trailer, data_ + size_ - sizeof(trailer), sizeof(trailer));
+    if (std::memcmp(trailer.magic, trajectoryFileMagic, sizeof(trailer.magic)) != 0)
+    {
+        return false;
+    }
+
+    const std::uint64_t indexEnd = size_ - sizeof(trailer);
+    if (trailer.indexOffset > indexEnd
+        || (indexEnd - trailer.indexOffset) / sizeof(TrajectoryIndexEntry) != trailer.chunkCount)
+    {
+        return false;
+    }
+
+    const auto *entries = reinterpret_cast<const TrajectoryIndexEntry*>(data_ + trailer.indexOffset);
+
+    chunks_.clear();
+    chunks_.reserve(static_cast<std::size_t>(trailer.chunkCount));
+
+    for (std::uint64_t i = 0; i < trailer.chunkCount; ++i)
+    {
+        const TrajectoryIndexEntry &entry = entries[i];
+        if (entry.offset + sizeof(TrajectoryChunkHeader) > trailer.indexOffset)
+        {
+            chunks_.clear();
+            return false;
+        }
+
+        const auto *header = reinterpret_cast<const TrajectoryChunkHeader*>(data_ + entry.offset);
+        chunks_.push_back(ChunkRef{ header, entry.firstSample, entry.tMin });
+    }
+
+    sampleCount_ = trailer.sampleCount;
+    return true;
+}
+
+void TrajectoryReader::scanChunks()
+{
+    chunks_.clear();
+    sampleCount_ = 0;
+
+    std::uint64_t offset = reinterpret_cast<const TrajectoryFileHeader*>(data_)->headerSize;
+
+    while (offset + sizeof(TrajectoryChunkHeader) <= size_)
+    {
+        const auto *header = reinterpret_cast<const TrajectoryChunkHeader*>(data_ + offset);
+        if (header->magic != trajectoryChunkMagic)
+        {
+            break;
+        }
+
+        const std::uint64_t end = offset + sizeof(TrajectoryChunkHeader) + header->payloadSize;
+        if (end > size_)
+        {
+            break; // truncated by a crash
+        }
+
+        chunks_.push_back(ChunkRef{ header, sampleCount_, header->tMin });
+        sampleCount_ += header->count;
+        offset = end;
+    }
+}
+
+bool TrajectoryReader::isOpen() const
+{
+    return data_ != nullptr;
+}
+
+bool TrajectoryReader::hasIndex() const
+{
+    return hasIndex_;
+}
+
+std::size_t TrajectoryReader::chunkCount() const
+{
+    return chunks_.size();
+}
+
+std::uint64_t TrajectoryReader::sampleCount() const
+{
+    return sampleCount_;
+}
+
+TrajectoryReader::Chunk TrajectoryReader::chunk(std::size_t index) const
+{
+    if (chunks_[index].header->codec == static_cast<std::uint32_t>(TrajectoryCodec::Raw))
+    {
+        return decodeChunk(index, cache_);
+    }
+
+    if (cachedChunk_ != index)
+    {
+        cachedView_ = decodeChunk(index, cache_);
+        cachedChunk_ = index;
+    }
+    return cachedView_;
+}
+
+TrajectoryReader::Chunk TrajectoryReader::decodeChunk(std::size_t index, ChunkBuffer &buffer) const
+{
+    const ChunkRef &ref = chunks_[index];
+    const TrajectoryChunkHeader *header = ref.header;
+
+    const auto *payload = reinterpret_cast<const unsigned char*>(header + 1);
+    const std::size_t available = size_ - static_cast<std::size_t>(payload - data_);
+    if (header->payloadSize > available)
+    {
+        return Chunk();
+    }
+
+    const std::size_t count = header->count;
+    const double *columns = nullptr;
+
+    if (header->codec == static_cast<std::uint32_t>(TrajectoryCodec::Raw))
+    {
+        if (header->payloadSize < count * trajectoryColumnCount * sizeof(double))
+        {
+            return Chunk();
+        }
+        columns = reinterpret_cast<const double*>(payload);
+    }
+    else if (header->codec == static_cast<std::uint32_t>(TrajectoryCodec::Delta))
+    {
+        buffer.values.resize(count * trajectoryColumnCount);
+
+        const unsigned char *p = payload;
+        const unsigned char *end = payload + header->payloadSize;
+
+        for (std::size_t c = 0; c < trajectoryColumnCount; ++c)
+        {
+            TrajectoryColumnHeader column;
+            if (static_cast<std::size_t>(end - p) < sizeof(column))
+            {
+                return Chunk();
+            }
+            std::memcpy(&column, p, sizeof(column));
+            p += sizeof(column);
+
+            if (column.size > static_cast<std::size_t>(end - p)
+                || !decodeDeltaColumn(p, static_cast<std::size_t>(column.size), count, column.quantum, buffer.values.data() + c * count))
+            {
+                return Chunk();
+            }
+
+            p += std::min<std::size_t>((static_cast<std::size_t>(column.size) + 7) & ~std::size_t(7), static_cast<std::size_t>(end - p));
+        }
+        columns = buffer.values.data();
+    }
+    else
+    {
+        return Chunk();
+    }
+
+    Chunk chunk;
+    chunk.header = header;
+    chunk.firstSample = ref.firstSample;
+
+    chunk.t = std::span<const double>(columns + ColumnT * count, count);
+    chunk.x = std::span<const double>(columns + ColumnX * count, count);
+    chunk.y = std::span<const double>(columns + ColumnY * count, count);
+    chunk.vx = std::span<const double>(columns + ColumnVx * count, count);
+    chunk.vy = std::span<const double>(columns + ColumnVy * count, count);
+    return chunk;
+}
+
+std::size_t TrajectoryReader::chunkForSample(std::uint64_t index) const
+{
+    const auto it = std::upper_bound(chunks_.begin(), chunks_.end(), index,
+                                     [](std::uint64_t i, const ChunkRef &ref) { return i < ref.firstSample; });
+    return (it == chunks_.begin()) ? 0 : static_cast<std::size_t>(it - chunks_.begin()) - 1;
+}
+
+TrajectorySample TrajectoryReader::sample(std::uint64_t index) const
+{
+    if (chunks_.empty() || index >= sampleCount_)
+    {
+        return TrajectorySample();
+    }
+
+    const Chunk c = chunk(chunkForSample(index));
+
+    TrajectorySample s;
+    if (index < c.firstSample || index - c.firstSample >= c.t.size())
+    {
+        return s; // corrupt chunk
+    }
+
+    const std::size_t i = static_cast<std::size_t>(index - c.firstSample);
+
+    s.time = c.t[i];
+    s.state.position = Vector2(c.x[i], c.y[i]);
+    s.state.velocity = Vector2(c.vx[i], c.vy[i]);
+    return s;
+}
+
+std::uint64_t TrajectoryReader::findSample(double t) const
+{
+    if (chunks_.empty())
+    {
+        return 0;
+    }
+
+    const auto it = std::upper_bound(chunks_.begin(), chunks_.end(), t,
+                                     [](double value, const ChunkRef &ref) { return value < ref.tMin; });
+    if (it == chunks_.begin())
+    {
+        return 0;
+    }
+
+    const std::size_t index = static_cast<std::size_t>(it - chunks_.begin()) - 1;
+    const Chunk c = chunk(index);
+    if (c.t.empty())
+    {
+        return chunks_[index].firstSample; // corrupt chunk
+    }
+    const auto within = std::upper_bound(c.t.begin(), c.t.end(), t);
+    if (within == c.t.begin())
+    {
+        return c.firstSample; // samples disagree with the chunk's tMin
+    }
+    return c.firstSample + static_cast<std::uint64_t>(within - c.t.begin()) - 1;
+}
+
+TrajectorySample TrajectoryReader::interpolate(double t) const
+{
+    if (sampleCount_ == 0)
+    {
+        return TrajectorySample();
+    }
+
+    const std::uint64_t i = findSample(t);
+    const TrajectorySample a = sample(i);
+    if (t <= a.time || i + 1 >= sampleCount_)
+    {
+        return a;
+    }
+
+    const TrajectorySample b = sample(i + 1);
+    const double h = b.time - a.time;
+    if (!(h > 0.0))
+    {
+        return a;
+    }
+
+    const double s = (t - a.time) / h;
+    const double s2 = s * s;
+    const double s3 = s2 * s;
+
+    const double h00 = 2.0 * s3 - 3.0 * s2 + 1.0;
+    const double h10 = s3 - 2.0 * s2 + s;
+    const double h01 = -2.0 * s3 + 3.0 * s2;
+    const double h11 = s3 - s2;
+
+    const double d00 = (6.0 * s2 - 6.0 * s) / h;
+    const double d10 = 3.0 * s2 - 4.0 * s + 1.0;
+    const double d01 = (-6.0 * s2 + 6.0 * s) / h;
+    const double d11 = 3.0 * s2 - 2.0 * s;
+
+    const State2 &p = a.state;
+    const State2 &q = b.state;
+
+    TrajectorySample out;
+    out.time = t;
+    out.state.position = Vector2(
+        h00 * p.position.x + h10 * h * p.velocity.x + h01 * q.position.x + h11 * h * q.velocity.x,
+        h00 * p.position.y + h10 * h * p.velocity.y + h01 * q.position.y + h11 * h * q.velocity.y);
+    out.state.velocity = Vector2(
+        d00 * p.position.x + d10 * p.velocity.x + d01 * q.position.x + d11 * q.velocity.x,
+        d00 * p.position.y + d10 * p.velocity.y + d01 * q.position.y + d11 * q.velocity.y);
+    return out;
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <vector>
+#include "../core/State2.h"
+
+// Binary trajectory file
+//
+//   TrajectoryFileHeader
+//   chunk 0: TrajectoryChunkHeader, payload
+//   chunk 1: ...
+//   TrajectoryIndexEntry[chunkCount]
+//   TrajectoryFileTrailer
+//
+// A raw payload holds `count` doubles each of t, x, y, vx, vy, one column
+// after the other (time in s, position in km, velocity in km/s). All records
+// are multiples of 8 bytes, so columns of a memory-mapped file can be used in
+// place. Values are stored in native byte order (little-endian on every
+// platform we build for).
+//
+// A delta payload holds the same five columns, each as a
+// TrajectoryColumnHeader followed by DeltaColumnCodec data padded to 8 bytes.
+// Chunks decode independently of each other.
+//
+// The index and trailer are written by close(). A file without them (the
+// writer crashed) is still readable: the reader then walks the chunk headers
+// and ignores a truncated last chunk.
+
+constexpr char trajectoryFileMagic[8] = { 'C', 'C', 'T', 'R', 'A', 'J', 0, 0 };
+constexpr std::uint32_t trajectoryFileVersion = 1;
+constexpr std::uint32_t trajectoryChunkMagic = 0x4b4e4843; // "CHNK"
+constexpr std::uint32_t trajectoryColumnCount = 5;
+
+enum class TrajectoryCodec : std::uint32_t
+{
+    Raw = 0,
+    Delta = 1    // see DeltaColumnCodec.h
+};
+
+// Writer settings. The quanta apply to Delta only: 0 keeps the column
+// lossless, otherwise values are rounded to multiples of the quantum.
+struct TrajectoryEncoding
+{
+    TrajectoryCodec codec = TrajectoryCodec::Raw;
+    double timeQuantum = 0.0;      // [s]
+    double positionQuantum = 0.0;  // [km]
+    double velocityQuantum = 0.0;  // [km/s]
+};
+
+struct TrajectoryFileHeader
+{
+    char magic[8];               // trajectoryFileMagic
+    std::uint32_t version;
+    std::uint32_t headerSize;    // sizeof(TrajectoryFileHeader)
+    std::uint32_t chunkSamples;  // samples per full chunk
+    std::uint32_t columnCount;   // trajectoryColumnCount
+    std::uint64_t reserved;
+};
+
+struct TrajectoryChunkHeader
+{
+    std::uint32_t magic;         // trajectoryChunkMagic
+    std::uint32_t codec;         // TrajectoryCodec
+    std::uint32_t count;         // samples in this chunk
+    std::uint32_t reserved;
+    std::uint64_t payloadSize;   // bytes following this header
+    double tMin;
+    double tMax;
+    double xMin;                 // bounding box of the positions
+    double xMax;
+    double yMin;
+    double yMax;
+};
+
+struct TrajectoryColumnHeader
+{
+    double quantum;              // 0 = lossless
+    std::uint64_t size;          // encoded bytes, before padding
+};
+
+struct TrajectoryIndexEntry
+{
+    std::uint64_t offset;        // of the chunk header, from the start of the file
+    std::uint64_t firstSample;
+    double tMin;
+    double tMax;
+};
+
+struct TrajectoryFileTrailer
+{
+    std::uint64_t indexOffset;
+    std::uint64_t chunkCount;
+    std::uint64_t sampleCount;
+    char magic[8];               // trajectoryFileMagic
+};
+
+struct TrajectorySample
+{
+    double time = 0.0;
+    State2 state;
+};
+
+// Appends samples and writes them a chunk at a time, so memory use does not
+// depend on the run length.
+class TrajectoryWriter
+{
+public:
+    explicit TrajectoryWriter(std::size_t chunkSamples = 4096, const TrajectoryEncoding &encoding = TrajectoryEncoding());
+    ~TrajectoryWriter();
+
+    TrajectoryWriter(const TrajectoryWriter&) = delete;
+    TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+    bool open(const std::string &path);
+
+    // Returns false once a write has failed.
+    bool append(double time, const State2 &state);
+
+    // Writes the buffered samples as a (short) chunk and flushes the file.
+    bool flush();
+
+    // Flushes, then writes the index and trailer.
+    bool close();
+
+    bool isOpen() const;
+    std::uint64_t sampleCount() const;
+
+private:
+    bool writeChunk();
+
+    std::FILE *file_ = nullptr;
+    bool failed_ = false;
+    std::size_t chunkSamples_;
+    TrajectoryEncoding encoding_;
+    std::uint64_t offset_ = 0;
+    std::uint64_t sampleCount_ = 0;
+
+    std::vector<double> columns_[trajectoryColumnCount];
+    std::vector<TrajectoryIndexEntry> index_;
+    std::vector<unsigned char> encoded_;
+};
+
+// Read-only view of a trajectory file through a memory mapping. Opening reads
+// the index only; samples are paged in when touched.
+class TrajectoryReader
+{
+public:
+    struct Chunk
+    {
+        const TrajectoryChunkHeader *header = nullptr;
+        std::uint64_t firstSample = 0;
+
+        std::span<const double> t;
+        std::span<const double> x;
+        std::span<const double> y;
+        std::span<const double> vx;
+        std::span<const double> vy;
+    };
+
+    // Decoded columns of one chunk, for decodeChunk().
+    struct ChunkBuffer
+    {
+        std::vector<double> values;
+    };
+
+    TrajectoryReader() = default;
+    ~TrajectoryReader();
+
+    TrajectoryReader(const TrajectoryReader&) = delete;
+    TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+
+    bool open(const std::string &path);
+    void close();
+
+    bool isOpen() const;
+    // False if the file had no index (the writer did not close it).
+    bool hasIndex() const;
+
+    std::size_t chunkCount() const;
+    std::uint64_t sampleCount() const;
+
+    // Raw chunks: the spans point into the mapping and stay valid until close().
+    // Encoded chunks are decoded into a one-chunk cache owned by the reader, so
+    // the spans are valid until the next call for another chunk; this makes the
+    // reader unsafe to share between threads.
+    Chunk chunk(std::size_t index) const;
+
+    // Thread-safe variant: encoded chunks are decoded into `buffer`. Returns an
+    // empty Chunk (header == nullptr) if the chunk is corrupt.
+    Chunk decodeChunk(std::size_t index, ChunkBuffer &buffer) const;
+
+    // A default TrajectorySample if index >= sampleCount().
+    TrajectorySample sample(std::uint64_t index) const;
+
+    // Index of the last sample with time <= t (0 if t is before the first).
+    std::uint64_t findSample(double t) const;
+
+    // Cubic Hermite interpolation between the samples around t, using the
+    // stored velocities; clamps to the first/last sample.
+    TrajectorySample interpolate(double t) const;
+
+private:
+    struct ChunkRef
+    {
+        const TrajectoryChunkHeader *header;
+        std::uint64_t firstSample;
+        double tMin;
+    };
+
+    bool readIndex();
+    void scanChunks();
+    std::size_t chunkForSample(std::uint64_t index) const; // 0 if before the first chunk
+
+    const unsigned char *data_ = nullptr;
+    std::size_t size_ = 0;
+
+    std::vector<ChunkRef> chunks_;
+    std::uint64_t sampleCount_ = 0;
+    bool hasIndex_ = false;
+
+    mutable ChunkBuffer cache_;
+    mutable Chunk cachedView_;
+    mutable std::size_t cachedChunk_ = static_cast<std::size_t>(-1);
+};
@@ -0,0 +1,397 @@
+#include "EnsemblePropagator.h"
+
+#include <cmath>
+#include "../core/Dynamics.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    // Body positions and parameters frozen at one stage time.
+    struct StageSources
+    {
+        double px[EnsemblePropagator::maxBodies];
+        double py[EnsemblePropagator::maxBodies];
+        double mu[EnsemblePropagator::maxBodies];
+        std::size_t count = 0;
+    };
+
+    StageSources sourcesAt(const std::vector<EnsembleBody> &bodies, double t)
+    {
+        StageSources s;
+
+        for (const EnsembleBody &body : bodies)
+        {
+            const Vector2 p = body.positionAt(t);
+            s.px[s.count] = p.x;
+            s.py[s.count] = p.y;
+            s.mu[s.count] = body.mu;
+            ++s.count;
+        }
+
+        return s;
+    }
+
+    // Minimal vector abstractions; the kernels are written once against them.
+    struct ScalarPack
+    {
+        using V = double;
+        static constexpr std::size_t width = 1;
+
+        static V load(const double *p) { return *p; }
+        static void store(double *p, V v) { *p = v; }
+        static V set1(double v) { return v; }
+        static V add(V a, V b) { return a + b; }
+        static V sub(V a, V b) { return a - b; }
+        static V mul(V a, V b) { return a * b; }
+        static V div(V a, V b) { return a / b; }
+        static V sqrt(V a) { return std::sqrt(a); }
+        static V fmadd(V a, V b, V c) { return a * b + c; }   // a * b + c
+        static V fnmadd(V a, V b, V c) { return c - a * b; }  // c - a * b
+    };
+
+#if defined(__SSE2__)
+    struct Sse2Pack
+    {
+        using V = __m128d;
+        static constexpr std::size_t width = 2;
+
+        static V load(const double *p) { return _mm_load_pd(p); }
+        static void store(double *p, V v) { _mm_store_pd(p, v); }
+        static V set1(double v) { return _mm_set1_pd(v); }
+        static V add(V a, V b) { return _mm_add_pd(a, b); }
+        static V sub(V a, V b) { return _mm_sub_pd(a, b); }
+        static V mul(V a, V b) { return _mm_mul_pd(a, b); }
+        static V div(V a, V b) { return _mm_div_pd(a, b); }
+        static V sqrt(V a) { return _mm_sqrt_pd(a); }
+        static V fmadd(V a, V b, V c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+        static V fnmadd(V a, V b, V c) { return _mm_sub_pd(c, _mm_mul_pd(a, b)); }
+    };
+#endif
+
+#if defined(__AVX2__)
+    struct Avx2Pack
+    {
+        using V = __m256d;
+        static constexpr std::size_t width = 4;
+
+        static V load(const double *p) { return _mm256_load_pd(p); }
+        static void store(double *p, V v) { _mm256_store_pd(p, v); }
+        static V set1(double v) { return _mm256_set1_pd(v); }
+        static V add(V a, V b) { return _mm256_add_pd(a, b); }
+        static V sub(V a, V b) { return _mm256_sub_pd(a, b); }
+        static V mul(V a, V b) { return _mm256_mul_pd(a, b); }
+        static V div(V a, V b) { return _mm256_div_pd(a, b); }
+        static V sqrt(V a) { return _mm256_sqrt_pd(a); }
+#if defined(__FMA__)
+        static V fmadd(V a, V b, V c) { return _mm256_fmadd_pd(a, b, c); }
+        static V fnmadd(V a, V b, V c) { return _mm256_fnmadd_pd(a, b, c); }
+#else
+        static V fmadd(V a, V b, V c) { return _mm256_add_pd(_mm256_mul_pd(a, b), c); }
+        static V fnmadd(V a, V b, V c) { return _mm256_sub_pd(c, _mm256_mul_pd(a, b)); }
+#endif
+    };
+#endif
+
+#if defined(__AVX2__)
+    using WidePack = Avx2Pack;
+#elif defined(__SSE2__)
+    using WidePack = Sse2Pack;
+#else
+    using WidePack = ScalarPack;
+#endif
+
+    // Point-mass acceleration at (x, y). A particle exactly on a body gets NaN;
+    // the ensemble has no collision handling.
+    template <typename P>
+    inline void acceleration(const StageSources &s,
+                             typename P::V x,
+                             typename P::V y,
+                             typename P::V &ax,
+                             typename P::V &ay)
+    {
+        using V = typename P::V;
+
+        ax = P::set1(0.0);
+        ay = P::set1(0.0);
+
+        for (std::size_t k = 0; k < s.count; ++k)
+        {
+            const V dx = P::sub(x, P::set1(s.px[k]));
+            const V dy = P::sub(y, P::set1(s.py[k]));
+            const V r2 = P::fmadd(dx, dx, P::mul(dy, dy));
+            const V r = P::sqrt(r2);
+            const V f = P::div(P::set1(s.mu[k]), P::mul(r2, r));
+
+            ax = P::fnmadd(f, dx, ax);
+            ay = P::fnmadd(f, dy, ay);
+        }
+    }
+
+    // Classic RK4 on particles [begin, end); all four stages of a particle are
+    // computed in registers. stages[0..2] hold the sources at t, t + h/2 and t + h.
+    template <typename P>
+    void rk4Range(std::size_t begin,
+                  std::size_t end,
+                  double *x, double *y, double *vx, double *vy,
+                  const StageSources (&stages)[3],
+                  double h)
+    {
+        using V = typename P::V;
+
+        const V half = P::set1(0.5 * h);
+        const V full = P::set1(h);
+        const V sixth = P::set1(h / 6.0);
+        const V two = P::set1(2.0);
+
+        for (std::size_t i = begin; i < end; i += P::width)
+        {
+            const V x0 = P::load(x + i);
+            const V y0 = P::load(y + i);
+            const V vx0 = P::load(vx + i);
+            const V vy0 = P::load(vy + i);
+
+            V a1x, a1y;
+            acceleration<P>(stages[0], x0, y0, a1x, a1y);
+
+            const V v2x = P::fmadd(half, a1x, vx0);
+            const V v2y = P::fmadd(half, a1y, vy0);
+            V a2x, a2y;
+            acceleration<P>(stages[1], P::fmadd(half, vx0, x0), P::fmadd(half, vy0, y0), a2x, a2y);
+
+            const V v3x = P::fmadd(half, a2x, vx0);
+            const V v3y = P::fmadd(half, a2y, vy0);
+            V a3x, a3y;
+            acceleration<P>(stages[1], P::fmadd(half, v2x, x0), P::fmadd(half, v2y, y0), a3x, a3y);
+
+            const V v4x = P::fmadd(full, a3x, vx0);
+            const V v4y = P::fmadd(full, a3y, vy0);
+            V a4x, a4y;
+            acceleration<P>(stages[2], P::fmadd(full, v3x, x0), P::fmadd(full, v3y, y0), a4x, a4y);
+
+            const V sumVx = P::fmadd(two, P::add(v2x, v3x), P::add(vx0, v4x));
+            const V sumVy = P::fmadd(two, P::add(v2y, v3y), P::add(vy0, v4y));
+            const V sumAx = P::fmadd(two, P::add(a2x, a3x), P::add(a1x, a4x));
+            const V sumAy = P::fmadd(two, P::add(a2y, a3y), P::add(a1y, a4y));
+
+            P::store(x + i, P::fmadd(sixth, sumVx, x0));
+            P::store(y + i, P::fmadd(sixth, sumVy, y0));
+            P::store(vx + i, P::fmadd(sixth, sumAx, vx0));
+            P::store(vy + i, P::fmadd(sixth, sumAy, vy0));
+        }
+    }
+
+    // Drift-kick-drift leapfrog composition with `count` kicks of weights[k] * h;
+    // kicks[k] holds the sources at the time of kick k.
+    template <typename P>
+    void composeRange(std::size_t begin,
+                      std::size_t end,
+                      double *x, double *y, double *vx, double *vy,
+                      const StageSources *kicks,
+                      const double *weights,
+                      std::size_t count,
+                      double h)
+    {
+        using V = typename P::V;
+
+        for (std::size_t i = begin; i < end; i += P::width)
+        {
+            V px = P::load(x + i);
+            V py = P::load(y + i);
+            V pvx = P::load(vx + i);
+            V pvy = P::load(vy + i);
+
+            const V firstDrift = P::set1(0.5 * weights[0] * h);
+            px = P::fmadd(firstDrift, pvx, px);
+            py = P::fmadd(firstDrift, pvy, py);
+
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                V ax, ay;
+                acceleration<P>(kicks[k], px, py, ax, ay);
+
+                const V kick = P::set1(weights[k] * h);
+                pvx = P::fmadd(kick, ax, pvx);
+                pvy = P::fmadd(kick, ay, pvy);
+
+                const double driftWeight = (k + 1 < count) ? 0.5 * (weights[k] + weights[k + 1]) : 0.5 * weights[k];
+                const V drift = P::set1(driftWeight * h);
+                px = P::fmadd(drift, pvx, px);
+                py = P::fmadd(drift, pvy, py);
+            }
+
+            P::store(x + i, px);
+            P::store(y + i, py);
+            P::store(vx + i, pvx);
+            P::store(vy + i, pvy);
+        }
+    }
+}
+
+Vector2 EnsembleBody::positionAt(double t) const
+{
+    const double angle = phase + angularSpeed * t;
+    return Vector2(orbitRadius * std::cos(angle), orbitRadius * std::sin(angle));
+}
+
+void EnsemblePropagator::addBody(const EnsembleBody &body)
+{
+    if (bodies_.size() < maxBodies)
+    {
+        bodies_.push_back(body);
+    }
+}
+
+void EnsemblePropagator::clearBodies()
+{
+    bodies_.clear();
+}
+
+std::size_t EnsemblePropagator::add(const State2 &state)
+{
+    x_.push_back(state.position.x);
+    y_.push_back(state.position.y);
+    vx_.push_back(state.velocity.x);
+    vy_.push_back(state.velocity.y);
+
+    return x_.size() - 1;
+}
+
+void EnsemblePropagator::clear()
+{
+    x_.clear();
+    y_.clear();
+    vx_.clear();
+    vy_.clear();
+}
+
+void EnsemblePropagator::reserve(std::size_t count)
+{
+    x_.reserve(count);
+    y_.reserve(count);
+    vx_.reserve(count);
+    vy_.reserve(count);
+}
+
+std::size_t EnsemblePropagator::size() const
+{
+    return x_.size();
+}
+
+State2 EnsemblePropagator::state(std::size_t index) const
+{
+    State2 s;
+    s.position = Vector2(x_[index], y_[index]);
+    s.velocity = Vector2(vx_[index], vy_[index]);
+    return s;
+}
+
+void EnsemblePropagator::setState(std::size_t index, const State2 &state)
+{
+    x_[index] = state.position.x;
+    y_[index] = state.position.y;
+    vx_[index] = state.velocity.x;
+    vy_[index] = state.velocity.y;
+}
+
+const EnsemblePropagator::Array& EnsemblePropagator::x() const
+{
+    return x_;
+}
+
+const EnsemblePropagator::Array& EnsemblePropagator::y() const
+{
+    return y_;
+}
+
+const EnsemblePropagator::Array& EnsemblePropagator::vx() const
+{
+    return vx_;
+}
+
+const EnsemblePropagator::Array& EnsemblePropagator::vy() const
+{
+    return vy_;
+}
+
+void EnsemblePropagator::step(double dt, Method method)
+{
+    const std::size_t n = size();
+    const std::size_t width = vectorized_ ? WidePack::width : 1;
+    const std::size_t wideEnd = n - n % width;
+
+    double *x = x_.data();
+    double *y = y_.data();
+    double *vx = vx_.data();
+    double *vy = vy_.data();
+
+    if (method == Method::RK4)
+    {
+        const StageSources stages[3] =
+        {
+            sourcesAt(bodies_, time_),
+            sourcesAt(bodies_, time_ + 0.5 * dt),
+            sourcesAt(bodies_, time_ + dt)
+        };
+
+        if (vectorized_)
+        {
+            rk4Range<WidePack>(0, wideEnd, x, y, vx, vy, stages, dt);
+        }
+        rk4Range<ScalarPack>(vectorized_ ? wideEnd : 0, n, x, y, vx, vy, stages, dt);
+    }
+    else
+    {
+        // Same weights as stepLeapfrog / stepYoshida4 in core/Dynamics.h.
+        static constexpr double leapfrogWeights[] = { 1.0 };
+        static constexpr double yoshida4Weights[] = { detail::yoshida4Outer, detail::yoshida4Inner, detail::yoshida4Outer };
+
+        const double *weights = (method == Method::Leapfrog) ? leapfrogWeights : yoshida4Weights;
+        const std::size_t count = (method == Method::Leapfrog) ? 1 : 3;
+
+        // Each kick happens after the drifts before it: at t + h * (w_0 + ... + w_(k-1) + w_k / 2).
+        StageSources kicks[3];
+        double elapsed = 0.0;
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            kicks[k] = sourcesAt(bodies_, time_ + dt * (elapsed + 0.5 * weights[k]));
+            elapsed += weights[k];
+        }
+
+        if (vectorized_)
+        {
+            composeRange<WidePack>(0, wideEnd, x, y, vx, vy, kicks, weights, count, dt);
+        }
+        composeRange<ScalarPack>(vectorized_ ? wideEnd : 0, n, x, y, vx, vy, kicks, weights, count, dt);
+    }
+
+    time_ += dt;
+}
+
+double EnsemblePropagator::time() const
+{
+    return time_;
+}
+
+void EnsemblePropagator::setTime(double t)
+{
+    time_ = t;
+}
+
+void EnsemblePropagator::setVectorized(bool enabled)
+{
+    vectorized_ = enabled;
+}
+
+const char* EnsemblePropagator::simdLevel()
+{
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
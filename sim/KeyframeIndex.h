@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "SimulationCheckpoint.h"
+
+// Keyframes and step log of one run, for seeking.
+//
+// Every step size is logged (run-length encoded, so a fixed-step run costs a
+// few bytes and a scheduled one a few per frame), and a checkpoint is kept
+// every `interval` steps. A seek restores the last keyframe before the target
+// and replays the logged steps from there, which reproduces the recorded run
+// bit for bit and costs at most one interval of steps. Keyframes carry no
+// trails (well under 1 KB each).
+//
+// After a seek the index follows the model along the log while it takes the
+// recorded steps; the first step that differs ends the recording there, and
+// the log and keyframes after it are dropped.
+class KeyframeIndex
+{
+public:
+    struct Keyframe
+    {
+        SimulationCheckpoint state;
+        std::uint64_t step = 0;     // steps taken before it
+    };
+
+    explicit KeyframeIndex(std::size_t interval = 1000) : interval_(interval)
+    {
+    }
+
+    // 0 stops adding keyframes (the existing ones stay usable).
+    void setInterval(std::size_t steps)
+    {
+        interval_ = steps;
+    }
+
+    std::size_t interval() const
+    {
+        return interval_;
+    }
+
+    // Counts a step of `stepSeconds` that ended at `time` and returns whether
+    // a keyframe should be added now.
+    bool stepTaken(double stepSeconds, double time)
+    {
+        if (position_ < stepCount_)
+        {
+            if (runs_[run_].step == stepSeconds)
+            {
+                ++position_;
+                if (position_ == runs_[run_].first + runs_[run_].count)
+                {
+                    ++run_;
+                }
+                return false;
+            }
+
+            truncate(time);
+        }
+
+        if (!runs_.empty() && runs_.back().step == stepSeconds)
+        {
+            ++runs_.back().count;
+        }
+        else
+        {
+            runs_.push_back(StepRun{ stepSeconds, stepCount_, 1 });
+        }
+
+        ++stepCount_;
+        position_ = stepCount_;
+        run_ = runs_.size();
+        endTime_ = time;
+
+        return interval_ != 0 && (keyframes_.empty() || position_ - keyframes_.back().step >= interval_);
+    }
+
+    // Only valid at the end of the recording (not while following the log).
+    void add(const SimulationCheckpoint &state)
+    {
+        keyframes_.push_back(Keyframe{ state, position_ });
+        endTime_ = std::max(endTime_, state.time);
+    }
+
+    // Drops the recording after the current position, e.g. when a parameter
+    // change makes the rest of it invalid. `time` is the current model time.
+    void truncate(double time)
+    {
+        while (!runs_.empty() && runs_.back().first >= position_)
+        {
+            runs_.pop_back();
+        }
+        if (!runs_.empty())
+        {
+            runs_.back().count = position_ - runs_.back().first;
+        }
+
+        while (!keyframes_.empty() && keyframes_.back().step > position_)
+        {
+            keyframes_.pop_back();
+        }
+
+        stepCount_ = position_;
+        run_ = runs_.size();
+        endTime_ = time;
+    }
+
+    void clear()
+    {
+        keyframes_.clear();
+        runs_.clear();
+        stepCount_ = 0;
+        position_ = 0;
+        run_ = 0;
+        endTime_ = 0.0;
+    }
+
+    // Last keyframe at or before `time`, nullptr if there is none.
+    const Keyframe* find(double time) const
+    {
+        const auto firstAfter = std::upper_bound(keyframes_.begin(), keyframes_.end(), time,
+            [](double t, const Keyframe &k) { return t < k.state.time; });
+        return firstAfter == keyframes_.begin() ? nullptr : &*(firstAfter - 1);
+    }
+
+    // Moves the position to `keyframe`, whose state the model has just restored.
+    void rewind(const Keyframe &keyframe)
+    {
+        position_ = keyframe.step;
+        run_ = static_cast<std::size_t>(std::upper_bound(runs_.begin(), runs_.end(), position_,
+            [](std::uint64_t p, const StepRun &r) { return p < r.first; }) - runs_.begin());
+        run_ = (run_ == 0) ? 0 : run_ - 1;
+
+        if (position_ == stepCount_)
+        {
+            run_ = runs_.size();
+        }
+    }
+
+    // Recorded size of the next step, 0 at the end of the recording.
+    double nextStep() const
+    {
+        return position_ < stepCount_ ? runs_[run_].step : 0.0;
+    }
+
+    bool empty() const
+    {
+        return keyframes_.empty();
+    }
+
+    std::size_t size() const
+    {
+        return keyframes_.size();
+    }
+
+    // Seekable range: from the first keyframe to the end of the recording.
+    double startTime() const
+    {
+        return keyframes_.empty() ? 0.0 : keyframes_.front().state.time;
+    }
+
+    double endTime() const
+    {
+        return endTime_;
+    }
+
+private:
+    struct StepRun
+    {
+        double step;
+        std::uint64_t first;        // index of the first step in the run
+        std::uint64_t count;
+    };
+
+    std::vector<Keyframe> keyframes_;
+    std::vector<StepRun> runs_;
+    std::size_t interval_;
+
+    std::uint64_t stepCount_ = 0;   // steps in the recording
+    std::uint64_t position_ = 0;    // steps the model has taken along it
+    std::size_t run_ = 0;           // run holding step `position_`
+    double endTime_ = 0.0;
+};
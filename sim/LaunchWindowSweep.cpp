@@ -0,0 +1,188 @@
+#include "LaunchWindowSweep.h"
+
+#include <cmath>
+#include <limits>
+#include "SimulationModel.h"
+
+LaunchWindowSweep::LaunchWindowSweep(const SweepSpec &spec)
+    : spec_(spec)
+{
+    results_.resize(cellCount());
+    done_ = std::make_unique<std::atomic<bool>[]>(results_.size());
+}
+
+LaunchWindowSweep::~LaunchWindowSweep()
+{
+    cancel();
+    wait();
+}
+
+const SweepSpec& LaunchWindowSweep::spec() const
+{
+    return spec_;
+}
+
+std::size_t LaunchWindowSweep::cellCount() const
+{
+    const auto n = [](const SweepRange &r) { return static_cast<std::size_t>(r.count > 1 ? r.count : 1); };
+    return n(spec_.radiusAu) * n(spec_.phaseDeg) * n(spec_.speed) * n(spec_.angleDeg) * n(spec_.epoch);
+}
+
+// Speed varies fastest, then angle, so a (speed, angle) slice is contiguous.
+std::size_t LaunchWindowSweep::flatIndex(const CellIndex &cell) const
+{
+    const auto n = [](const SweepRange &r) { return static_cast<std::size_t>(r.count > 1 ? r.count : 1); };
+
+    std::size_t flat = static_cast<std::size_t>(cell.epoch);
+    flat = flat * n(spec_.radiusAu) + static_cast<std::size_t>(cell.radius);
+    flat = flat * n(spec_.phaseDeg) + static_cast<std::size_t>(cell.phase);
+    flat = flat * n(spec_.angleDeg) + static_cast<std::size_t>(cell.angle);
+    flat = flat * n(spec_.speed) + static_cast<std::size_t>(cell.speed);
+    return flat;
+}
+
+LaunchWindowSweep::CellIndex LaunchWindowSweep::cellIndex(std::size_t flat) const
+{
+    const auto n = [](const SweepRange &r) { return static_cast<std::size_t>(r.count > 1 ? r.count : 1); };
+
+    CellIndex cell;
+    cell.speed = static_cast<int>(flat % n(spec_.speed));
+    flat /= n(spec_.speed);
+    cell.angle = static_cast<int>(flat % n(spec_.angleDeg));
+    flat /= n(spec_.angleDeg);
+    cell.phase = static_cast<int>(flat % n(spec_.phaseDeg));
+    flat /= n(spec_.phaseDeg);
+    cell.radius = static_cast<int>(flat % n(spec_.radiusAu));
+    flat /= n(spec_.radiusAu);
+    cell.epoch = static_cast<int>(flat);
+    return cell;
+}
+
+ScenarioParams LaunchWindowSweep::scenarioFor(std::size_t flat) const
+{
+    const CellIndex cell = cellIndex(flat);
+
+    const double rKm = spec_.radiusAu.value(cell.radius) * AU_KM;
+    const double phase = math::deg2rad(spec_.phaseDeg.value(cell.phase));
+    const double speed = spec_.speed.value(cell.speed);
+    const double angle = math::deg2rad(spec_.angleDeg.value(cell.angle));
+
+    ScenarioParams params;
+    params.shipPosition = Vector2(rKm * std::cos(phase), rKm * std::sin(phase));
+    params.shipVelocity = Vector2(speed * std::cos(angle), speed * std::sin(angle));
+    params.dt = spec_.sampleStep;
+    params.startEpoch = spec_.epoch.value(cell.epoch);
+    params.clearTrajectoriesOnReset = true;
+    params.autoAlignPlanetForAssist = false;
+
+    return params;
+}
+
+void LaunchWindowSweep::start(std::size_t threadCount)
+{
+    if (pool_)
+    {
+        return;
+    }
+
+    pool_ = std::make_unique<WorkStealingPool>(threadCount);
+
+    for (std::size_t i = 0; i < results_.size(); ++i)
+    {
+        pool_->submit([this, i]() { runCell(i); });
+    }
+}
+
+void LaunchWindowSweep::cancel()
+{
+    cancel_ = true;
+}
+
+void LaunchWindowSweep::wait()
+{
+    if (pool_)
+    {
+        pool_->wait();
+    }
+}
+
+bool LaunchWindowSweep::isDone(std::size_t flat) const
+{
+    return done_[flat].load(std::memory_order_acquire);
+}
+
+const SweepMetrics& LaunchWindowSweep::result(std::size_t flat) const
+{
+    return results_[flat];
+}
+
+std::size_t LaunchWindowSweep::completedCount() const
+{
+    return completed_.load(std::memory_order_relaxed);
+}
+
+void LaunchWindowSweep::runCell(std::size_t flat)
+{
+    if (cancel_)
+    {
+        return;
+    }
+
+    results_[flat] = evaluate(scenarioFor(flat), spec_, &cancel_);
+
+    done_[flat].store(true, std::memory_order_release);
+    completed_.fetch_add(1, std::memory_order_relaxed);
+}
+
+SweepMetrics LaunchWindowSweep::evaluate(const ScenarioParams &params, const SweepSpec &spec, const std::atomic<bool> *cancel)
+{
+    State2 initial;
+    initial.position = params.shipPosition;
+    initial.velocity = params.shipVelocity;
+
+    // Trails are not recorded; a capacity of 1 keeps the model small.
+    SimulationModel model(initial, MU_SUN, params.dt, spec.integrator, 1);
+    model.reset(params);
+
+    const Body &jupiter = model.jupiter();
+    const double jupiterOrbit = radiusFromPosition(jupiter.position);
+    const double sphereOfInfluence = jupiterOrbit * std::pow(jupiter.mu / MU_SUN, 0.4);
+
+    SweepMetrics metrics;
+    metrics.minJupiterDistance = std::numeric_limits<double>::infinity();
+
+    bool enteredSphere = false;
+    double t = 0.0;
+
+    while (t < spec.duration)
+    {
+        if (cancel != nullptr && cancel->load(std::memory_order_relaxed))
+        {
+            break;
+        }
+
+        model.advance(spec.sampleStep);
+        t += spec.sampleStep;
+
+        const double distance = radiusFromPosition(model.state().position - model.jupiterPosition());
+
+        if (distance < metrics.minJupiterDistance)
+        {
+            metrics.minJupiterDistance = distance;
+            metrics.closestApproachTime = t;
+        }
+
+        if (distance < sphereOfInfluence)
+        {
+            enteredSphere = true;
+        }
+        else if (enteredSphere && distance > 2.0 * metrics.minJupiterDistance)
+        {
+            metrics.flybyCompleted = true;
+            break;
+        }
+    }
+
+    metrics.postFlybySpeed = speedFromVelocity(model.state().velocity);
+    return metrics;
+}
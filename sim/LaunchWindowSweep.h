@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "ScenarioParams.h"
+#include "SimulationController.h"
+#include "WorkStealingPool.h"
+
+// Evenly spaced sweep axis; count == 1 uses `min` only.
+struct SweepRange
+{
+    double min = 0.0;
+    double max = 0.0;
+    int count = 1;
+
+    double value(int index) const
+    {
+        return (count <= 1) ? min : min + (max - min) * static_cast<double>(index) / static_cast<double>(count - 1);
+    }
+};
+
+struct SweepSpec
+{
+    SweepRange radiusAu{ 1.0, 1.0, 1 };     // launch radius [AU]
+    SweepRange phaseDeg{ 0.0, 0.0, 1 };     // launch position angle [deg]
+    SweepRange speed{ 40.0, 40.0, 1 };      // launch speed [km/s]
+    SweepRange angleDeg{ 90.0, 90.0, 1 };   // launch direction [deg]
+    SweepRange epoch{ 0.0, 0.0, 1 };        // departure epoch [s], see ScenarioParams::startEpoch
+
+    double duration = 5.0 * 365.0 * 86400.0; // longest propagation per cell [s]
+    double sampleStep = 3.0 * 3600.0;        // interval between distance samples [s]
+    IntegratorType integrator = IntegratorType::DormandPrince45;
+};
+
+struct SweepMetrics
+{
+    double minJupiterDistance = 0.0;   // [km]
+    double closestApproachTime = 0.0;  // [s] after departure
+    double postFlybySpeed = 0.0;       // heliocentric [km/s], see LaunchWindowSweep
+    bool flybyCompleted = false;       // left Jupiter's sphere of influence after entering it
+};
+
+// Grid search over launch conditions, run on a WorkStealingPool.
+//
+// Every cell of the five-dimensional grid is propagated with SimulationModel
+// (same physics as the interactive view) and reduced to a few metrics. A cell
+// stops early once a flyby is over: after entering Jupiter's sphere of
+// influence, as soon as it is outside it again and twice as far as at closest
+// approach. postFlybySpeed is the heliocentric speed at that moment, or at the
+// end of the propagation if no flyby completed.
+//
+// Results become readable cell by cell while the sweep runs: isDone(i) turns
+// true once result(i) is final.
+class LaunchWindowSweep
+{
+public:
+    struct CellIndex
+    {
+        int radius = 0;
+        int phase = 0;
+        int speed = 0;
+        int angle = 0;
+        int epoch = 0;
+    };
+
+    explicit LaunchWindowSweep(const SweepSpec &spec);
+    ~LaunchWindowSweep();
+
+    LaunchWindowSweep(const LaunchWindowSweep&) = delete;
+    LaunchWindowSweep& operator=(const LaunchWindowSweep&) = delete;
+
+    const SweepSpec& spec() const;
+
+    std::size_t cellCount() const;
+    std::size_t flatIndex(const CellIndex &cell) const;
+    CellIndex cellIndex(std::size_t flat) const;
+    ScenarioParams scenarioFor(std::size_t flat) const;
+
+    // Starts the sweep on `threadCount` threads (0 = all cores); returns immediately.
+    void start(std::size_t threadCount = 0);
+    void cancel();
+    void wait();
+
+    bool isDone(std::size_t flat) const;
+    const SweepMetrics& result(std::size_t flat) const;
+    std::size_t completedCount() const;
+
+    // Propagates one scenario synchronously.
+    static SweepMetrics evaluate(const ScenarioParams &params, const SweepSpec &spec, const std::atomic<bool> *cancel = nullptr);
+
+private:
+    void runCell(std::size_t flat);
+
+    SweepSpec spec_;
+    std::vector<SweepMetrics> results_;
+    std::unique_ptr<std::atomic<bool>[]> done_;
+    std::atomic<std::size_t> completed_{0};
+    std::atomic<bool> cancel_{false};
+    std::unique_ptr<WorkStealingPool> pool_;
+};
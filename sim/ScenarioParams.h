@@ -9,6 +9,10 @@ struct ScenarioParams
 
     double dt = 0.1;
 
+    // Departure epoch [s]: the planets start where their circular orbits put
+    // them this long after the reference configuration (all at angle 0).
+    double startEpoch = 0.0;
+
     bool clearTrajectoriesOnReset = true;
 
     bool autoAlignPlanetForAssist = false;
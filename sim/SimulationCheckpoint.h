@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+#include "SimulationController.h"
+#include "../core/Body.h"
+#include "../core/Vector2.h"
+
+// Complete SimulationModel state; see SimulationModel::checkpoint().
+struct SimulationCheckpoint
+{
+    ControllerCheckpoint controller;
+    double time = 0.0;
+    double timeScale = 0.0;
+
+    Body sun;
+    Body jupiter;
+    Body earth;
+
+    double jupiterAngle = 0.0;
+    double jupiterOrbitRadius = 0.0;
+    double jupiterAngularSpeed = 0.0;
+    double jupiterPhase = 0.0;
+    double earthAngle = 0.0;
+    double earthOrbitRadius = 0.0;
+    double earthAngularSpeed = 0.0;
+    double earthPhase = 0.0;
+
+    bool trailBreakPending = false; // the next trail point starts a new segment
+
+    // Trail points, oldest first; only filled when hasTrails is set.
+    bool hasTrails = false;
+    std::vector<Vector2> shipTrail;
+    std::vector<Vector2> jupiterTrail;
+    std::vector<Vector2> earthTrail;
+};
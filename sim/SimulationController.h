@@ -2,12 +2,41 @@
 
 #include "../core/State2.h"
 #include "../core/Dynamics.h"
+#include "../core/KeplerPropagator.h"
+#include "../core/PointMassField.h"
+#include "../core/TaylorIntegrator.h"
 #include <functional>
+#include <type_traits>
 
 enum class IntegratorType
 {
     RK4,
-    Euler
+    Euler,
+    DormandPrince45, // adaptive; dt is the interval covered per step, not the step size
+    Leapfrog,        // symplectic, 2nd order
+    Yoshida4,        // symplectic, 4th order
+    Yoshida6,        // symplectic, 6th order
+    AdamsBashforthMoulton4, // multistep PECE; restarts when dt changes
+    Taylor                  // high-order Taylor series with automatic order/step; needs a PointMassField
+};
+
+// Everything the next step depends on, for SimulationController::checkpoint().
+struct ControllerCheckpoint
+{
+    State2 state;
+    double mu = 0.0;
+    double dt = 0.0;
+    IntegratorType integrator = IntegratorType::RK4;
+
+    AdaptiveStepOptions adaptiveOptions;
+    AdaptiveStepStats adaptiveStats;
+    TaylorOptions taylorOptions;
+    double adaptiveStep = 0.0;
+    MultistepHistory history;
+
+    bool keplerCoast = false;
+    double coastThreshold = 1e-4;
+    bool coasting = false;
 };
 
 class SimulationController
@@ -19,11 +48,37 @@ public:
 
     void step()
     {
+        // Without third bodies the motion is exactly two-body.
+        coasting_ = keplerCoast_;
+        if (coasting_)
+        {
+            state_ = propagateKepler(state_, mu_, dt_);
+            return;
+        }
+
         switch (integrator_)
         {
         case IntegratorType::Euler:
             state_ = stepEuler(state_, dt_, mu_);
             break;
+        case IntegratorType::DormandPrince45:
+            state_ = stepDormandPrince45(state_, dt_, adaptiveStep_, mu_, adaptiveOptions_, adaptiveStats_);
+            break;
+        case IntegratorType::Leapfrog:
+            state_ = stepLeapfrog(state_, dt_, mu_);
+            break;
+        case IntegratorType::Yoshida4:
+            state_ = stepYoshida4(state_, dt_, mu_);
+            break;
+        case IntegratorType::Yoshida6:
+            state_ = stepYoshida6(state_, dt_, mu_);
+            break;
+        case IntegratorType::AdamsBashforthMoulton4:
+            state_ = stepAdamsBashforthMoulton4(state_, dt_, mu_, history_);
+            break;
+        case IntegratorType::Taylor:
+            state_ = stepTaylor(state_, dt_, mu_, taylorOptions_, adaptiveStats_);
+            break;
         case IntegratorType::RK4:
         default:
             state_ = stepRK4(state_, dt_, mu_);
@@ -31,13 +86,51 @@ public:
         }
     }
 
-    void stepWithAcceleration(const std::function<Vector2(const Vector2&)> &accel)
+    // The force model is a template parameter so it inlines into every stage.
+    template <AccelerationField Accel>
+    void stepWithAcceleration(Accel &&accel)
     {
+        if constexpr (std::is_same_v<std::remove_cvref_t<Accel>, PointMassField>)
+        {
+            if (tryCoast(accel))
+            {
+                return;
+            }
+        }
+        coasting_ = false;
+
         switch (integrator_)
         {
         case IntegratorType::Euler:
             state_ = stepEuler(state_, dt_, accel);
             break;
+        case IntegratorType::DormandPrince45:
+            state_ = stepDormandPrince45(state_, dt_, adaptiveStep_, accel, adaptiveOptions_, adaptiveStats_);
+            break;
+        case IntegratorType::Leapfrog:
+            state_ = stepLeapfrog(state_, dt_, accel);
+            break;
+        case IntegratorType::Yoshida4:
+            state_ = stepYoshida4(state_, dt_, accel);
+            break;
+        case IntegratorType::Yoshida6:
+            state_ = stepYoshida6(state_, dt_, accel);
+            break;
+        case IntegratorType::AdamsBashforthMoulton4:
+            state_ = stepAdamsBashforthMoulton4(state_, dt_, accel, history_);
+            break;
+        case IntegratorType::Taylor:
+            // The series is built from the structure of the field; an arbitrary
+            // callable has none, so it is integrated adaptively instead.
+            if constexpr (std::is_same_v<std::remove_cvref_t<Accel>, PointMassField>)
+            {
+                state_ = stepTaylor(state_, dt_, accel, taylorOptions_, adaptiveStats_);
+            }
+            else
+            {
+                state_ = stepDormandPrince45(state_, dt_, adaptiveStep_, accel, adaptiveOptions_, adaptiveStats_);
+            }
+            break;
         case IntegratorType::RK4:
         default:
             state_ = stepRK4(state_, dt_, accel);
@@ -45,9 +138,16 @@ public:
         }
     }
 
+    void stepWithAcceleration(const AccelerationFunction &accel)
+    {
+        stepWithAcceleration<const AccelerationFunction&>(accel);
+    }
+
     void reset(const State2 &newState)
     {
         state_ = newState;
+        adaptiveStep_ = 0.0;
+        history_.clear();
     }
 
     const State2& state() const
@@ -68,11 +168,14 @@ public:
     void setMu(double newMu)
     {
         mu_ = newMu;
+        history_.clear();
     }
 
     void setIntegrator(IntegratorType type)
     {
         integrator_ = type;
+        adaptiveStep_ = 0.0;
+        history_.clear();
     }
 
     IntegratorType integrator() const
@@ -80,9 +183,161 @@ public:
         return integrator_;
     }
 
+    void setAdaptiveOptions(const AdaptiveStepOptions &options)
+    {
+        adaptiveOptions_ = options;
+    }
+
+    const AdaptiveStepOptions& adaptiveOptions() const
+    {
+        return adaptiveOptions_;
+    }
+
+    void setTaylorOptions(const TaylorOptions &options)
+    {
+        taylorOptions_ = options;
+    }
+
+    const TaylorOptions& taylorOptions() const
+    {
+        return taylorOptions_;
+    }
+
+    // Kepler coasting: when the acceleration from every source but the first
+    // (the primary) is below `threshold` times the primary's, steps with a
+    // PointMassField are taken analytically with propagateKepler() around the
+    // primary instead of by the integrator.
+    void setKeplerCoast(bool enabled, double threshold = 1e-4)
+    {
+        keplerCoast_ = enabled;
+        coastThreshold_ = threshold;
+    }
+
+    bool keplerCoast() const
+    {
+        return keplerCoast_;
+    }
+
+    double coastThreshold() const
+    {
+        return coastThreshold_;
+    }
+
+    // Whether the most recent step was taken analytically.
+    bool isCoasting() const
+    {
+        return coasting_;
+    }
+
+    // Whether a step in `field` from the current state would be coasted.
+    bool canCoast(const PointMassField &field) const
+    {
+        if (!keplerCoast_ || field.count == 0)
+        {
+            return false;
+        }
+
+        const PointMassField::Source &primary = field.sources[0];
+
+        PointMassField others;
+        for (std::size_t i = 1; i < field.count; ++i)
+        {
+            others.add(field.sources[i].position, field.sources[i].mu);
+        }
+
+        PointMassField central;
+        central.add(primary.position, primary.mu);
+
+        const double primaryAccel = speedFromVelocity(central(state_.position));
+        const double perturbation = speedFromVelocity(others(state_.position));
+
+        return primaryAccel != 0.0 && perturbation <= coastThreshold_ * primaryAccel;
+    }
+
+    // Accepted/rejected internal steps of the adaptive integrators so far.
+    const AdaptiveStepStats& adaptiveStats() const
+    {
+        return adaptiveStats_;
+    }
+
+    void resetAdaptiveStats()
+    {
+        adaptiveStats_ = AdaptiveStepStats();
+    }
+
+    // Restoring a checkpoint continues bit-identically to the controller it
+    // was taken from, including the adaptive step and multistep history.
+    ControllerCheckpoint checkpoint() const
+    {
+        ControllerCheckpoint c;
+        c.state = state_;
+        c.mu = mu_;
+        c.dt = dt_;
+        c.integrator = integrator_;
+        c.adaptiveOptions = adaptiveOptions_;
+        c.adaptiveStats = adaptiveStats_;
+        c.taylorOptions = taylorOptions_;
+        c.adaptiveStep = adaptiveStep_;
+        c.history = history_;
+        c.keplerCoast = keplerCoast_;
+        c.coastThreshold = coastThreshold_;
+        c.coasting = coasting_;
+        return c;
+    }
+
+    void restore(const ControllerCheckpoint &c)
+    {
+        state_ = c.state;
+        mu_ = c.mu;
+        dt_ = c.dt;
+        integrator_ = c.integrator;
+        adaptiveOptions_ = c.adaptiveOptions;
+        adaptiveStats_ = c.adaptiveStats;
+        taylorOptions_ = c.taylorOptions;
+        adaptiveStep_ = c.adaptiveStep;
+        history_ = c.history;
+        keplerCoast_ = c.keplerCoast;
+        coastThreshold_ = c.coastThreshold;
+        coasting_ = c.coasting;
+    }
+
 private:
+    bool tryCoast(const PointMassField &field)
+    {
+        if (!canCoast(field))
+        {
+            return false;
+        }
+
+        const PointMassField::Source &primary = field.sources[0];
+
+        State2 relative;
+        relative.position = state_.position - primary.position;
+        relative.velocity = state_.velocity;
+
+        relative = propagateKepler(relative, primary.mu, dt_);
+
+        state_.position = relative.position + primary.position;
+        state_.velocity = relative.velocity;
+
+        // The integrator's own history does not describe the coasted arc.
+        history_.clear();
+        coasting_ = true;
+        return true;
+    }
+
     State2 state_;
     double mu_;
     double dt_;
     IntegratorType integrator_;
+
+    AdaptiveStepOptions adaptiveOptions_;
+    AdaptiveStepStats adaptiveStats_;
+    TaylorOptions taylorOptions_;
+    double adaptiveStep_ = 0.0; // step proposed by the last adaptive call; 0 = pick a new one
+    MultistepHistory history_;  // derivative history of the multistep integrator
+
+    bool keplerCoast_ = false;
+    double coastThreshold_ = 1e-4;
+    bool coasting_ = false;
 };
\ No newline at end of file
@@ -9,7 +9,9 @@ SimulationModel::SimulationModel(const State2 &initialState,
                                  std::size_t trajectoryMaxSize) 
     : controller_(initialState, muValue, dtValue, integratorType), 
       clock_(0.0), 
-      trajectory_(trajectoryMaxSize)
+      trajectory_(trajectoryMaxSize),
+      jupiterTrajectory_(trajectoryMaxSize),
+      earthTrajectory_(trajectoryMaxSize)
 {
     trajectory_.addPoint(initialState.position);
 
@@ -18,13 +20,13 @@ SimulationModel::SimulationModel(const State2 &initialState,
 
     jupiter_.mu = 1.26686534e8;
     jupiter_.position = Vector2(jupiterOrbitRadius_, 0.0);
-    jupiterAngularSpeed_ = std::sqrt(sun_.mu / (jupiterOrbitRadius_ * jupiterOrbitRadius_ * jupiterOrbitRadius_));
-
     earth_.position = Vector2(earthOrbitRadius_, 0.0);
-    earthAngularSpeed_ = std::sqrt(sun_.mu / (earthOrbitRadius_ * earthOrbitRadius_ * earthOrbitRadius_));
+    updateAngularSpeeds();
 
     earthTrajectory_.addPoint(earth_.position);
     jupiterTrajectory_.addPoint(jupiter_.position);
+
+    addKeyframe();
 }
 
 static double wrapAngleRadians(double a)
@@ -48,33 +50,56 @@ static Vector2 positionOnCircle(double radius, double angleRad)
 
 void SimulationModel::update()
 {
-    const double dtEff = dt() * timeScale_;
+    advance(dt() * timeScale_);
+    recordTrailPoints();
+}
 
-    jupiterAngle_ += jupiterAngularSpeed_ * dtEff;
+void SimulationModel::advance(double stepSeconds)
+{
+    jupiterAngle_ += jupiterAngularSpeed_ * stepSeconds;
 
     jupiter_.position.x = jupiterOrbitRadius_ * std::cos(jupiterAngle_);
     jupiter_.position.y = jupiterOrbitRadius_ * std::sin(jupiterAngle_);
 
-    earthAngle_ += earthAngularSpeed_ * dtEff;
+    earthAngle_ += earthAngularSpeed_ * stepSeconds;
 
     earth_.position.x = earthOrbitRadius_ * std::cos(earthAngle_);
     earth_.position.y = earthOrbitRadius_ * std::sin(earthAngle_);
 
 
     const double originalDt = controller_.dt();
-    controller_.setDt(dtEff);
-    controller_.stepWithAcceleration([this](const Vector2 &pos)
+    controller_.setDt(stepSeconds);
+    PointMassField field;
+    field.add(sun_);
+    field.add(jupiter_);
+    if (earth_.mu > 0.0)
     {
-        const Vector2 aSun = gravitaionalAccelerationFromBody(pos, sun_);
-        const Vector2 aJupiter = gravitaionalAccelerationFromBody(pos, jupiter_);
-        return aSun + aJupiter;
-    });
+        field.add(earth_);
+    }
+    controller_.stepWithAcceleration(field);
     controller_.setDt(originalDt);
 
-    clock_.advance(dtEff);
-    trajectory_.addPoint(controller_.state().position);
-    earthTrajectory_.addPoint(earth_.position);
-    jupiterTrajectory_.addPoint(jupiter_.position);
+    clock_.advance(stepSeconds);
+
+    if (keyframes_.stepTaken(stepSeconds, clock_.time()))
+    {
+        addKeyframe();
+    }
+}
+
+void SimulationModel::recordTrailPoints()
+{
+    if (trailBreakPending_)
+    {
+        addTrailBreak(TrailBody::Ship);
+        addTrailBreak(TrailBody::Earth);
+        addTrailBreak(TrailBody::Jupiter);
+        trailBreakPending_ = false;
+    }
+
+    addTrailPoint(TrailBody::Ship, controller_.state().position);
+    addTrailPoint(TrailBody::Earth, earth_.position);
+    addTrailPoint(TrailBody::Jupiter, jupiter_.position);
 }
 
 void SimulationModel::reset(const ScenarioParams &params)
@@ -88,8 +113,8 @@ void SimulationModel::reset(const ScenarioParams &params)
     controller_.reset(shipState);
     clock_.reset(0.0);
 
-    jupiterAngle_ = 0.0;
-    earthAngle_ = 0.0;
+    jupiterAngle_ = jupiterPhase_ + jupiterAngularSpeed_ * params.startEpoch;
+    earthAngle_ = earthPhase_ + earthAngularSpeed_ * params.startEpoch;
 
     if (params.autoAlignPlanetForAssist)
     {
@@ -99,45 +124,20 @@ void SimulationModel::reset(const ScenarioParams &params)
 
         if (planet.body != nullptr && planet.angle != nullptr && planet.orbitRadius != nullptr && planet.angularSpeed != nullptr)
         {
-            State2 probe = shipState;
-
-            double t = 0.0;
-            const double dtPred = params.dt * 1000;
-
             const double rTarget = *planet.orbitRadius;
-            const double tol = 0.01 * rTarget;
-
             const double maxPredictTime = 60.0 * 60.0 * 24.0 * 365.0 * 5.0;
 
-            bool found = false;
-            double thetaShip = 0.0;
-            double tHit = 0.0;
+            // Crossing time on the heliocentric conic (the planets are ignored).
+            State2 relative = shipState;
+            relative.position = shipState.position - sun_.position;
 
-            while (t < maxPredictTime)
-            {
-                probe = stepRK4(
-                    probe, dtPred, [this](const Vector2& pos)
-                    {
-                        return gravitaionalAccelerationFromBody(pos, sun_);
-                    }
-                );
-
-                t += dtPred;
-
-                const double r = std::sqrt(probe.position.x * probe.position.x + probe.position.y * probe.position.y);
-                if (std::abs(r - rTarget) < tol)
-                {
-                    thetaShip = polarAngle(probe.position);
-                    tHit = t;
-                    found = true;
-                    break;
-                }
-            }
+            const double tHit = timeToRadius(relative, sun_.mu, rTarget, maxPredictTime);
 
-            if (found)
+            if (tHit > 0.0)
             {
+                const double thetaShip = polarAngle(propagateKepler(relative, sun_.mu, tHit).position);
                 const double omega = *planet.angularSpeed;
-                
+
                 const double biasRad = 1.0 * (pi / 180.0);
 
                 *planet.angle = wrapAngleRadians(thetaShip - omega * tHit + biasRad);
@@ -148,22 +148,26 @@ void SimulationModel::reset(const ScenarioParams &params)
     jupiter_.position = positionOnCircle(jupiterOrbitRadius_, jupiterAngle_);
     earth_.position = positionOnCircle(earthOrbitRadius_, earthAngle_);
 
+    trailBreakPending_ = false;
+    keyframes_.clear();
+    addKeyframe();
+
     if (params.clearTrajectoriesOnReset)
     {
-        trajectory_.clear();
-        earthTrajectory_.clear();
-        jupiterTrajectory_.clear();
+        clearTrail(TrailBody::Ship);
+        clearTrail(TrailBody::Earth);
+        clearTrail(TrailBody::Jupiter);
     }
     else 
     {
-        trajectory_.addBreak();
-        earthTrajectory_.addBreak();
-        jupiterTrajectory_.addBreak();
+        addTrailBreak(TrailBody::Ship);
+        addTrailBreak(TrailBody::Earth);
+        addTrailBreak(TrailBody::Jupiter);
     }
 
-    trajectory_.addPoint(shipState.position);
-    earthTrajectory_.addPoint(earth_.position);
-    jupiterTrajectory_.addPoint(jupiter_.position);
+    addTrailPoint(TrailBody::Ship, shipState.position);
+    addTrailPoint(TrailBody::Earth, earth_.position);
+    addTrailPoint(TrailBody::Jupiter, jupiter_.position);
 }
 
 const State2& SimulationModel::state() const
@@ -176,9 +180,9 @@ double SimulationModel::time() const
     return clock_.time();
 }
 
-const std::vector<Vector2>& SimulationModel::trajectory() const
+const TrajectoryBuffer& SimulationModel::trajectory() const
 {
-    return trajectory_.points();
+    return trajectory_;
 }
 
 const Body& SimulationModel::sun() const
@@ -202,9 +206,9 @@ const Vector2& SimulationModel::jupiterPosition() const
 }
 
     
-const std::vector<Vector2>& SimulationModel::jupiterTrajectory() const
+const TrajectoryBuffer& SimulationModel::jupiterTrajectory() const
 {
-    return jupiterTrajectory_.points();
+    return jupiterTrajectory_;
 }
 
 const Vector2& SimulationModel::earthPosition() const
@@ -212,9 +216,9 @@ const Vector2& SimulationModel::earthPosition() const
     return earth_.position;
 }
 
-const std::vector<Vector2>& SimulationModel::earthTrajectory() const
+const TrajectoryBuffer& SimulationModel::earthTrajectory() const
 {
-    return earthTrajectory_.points();
+    return earthTrajectory_;
 }
 
 double SimulationModel::dt() const
@@ -225,16 +229,55 @@ double SimulationModel::dt() const
 void SimulationModel::setDt(double newDt)
 {
     controller_.setDt(newDt);
+    keyframes_.truncate(clock_.time());
 }
 
 void SimulationModel::setMu(double newMu)
 {
     controller_.setMu(newMu);
+    keyframes_.truncate(clock_.time());
 }
 
 void SimulationModel::setIntegrator(IntegratorType type)
 {
     controller_.setIntegrator(type);
+    keyframes_.truncate(clock_.time());
+}
+
+void SimulationModel::setAdaptiveOptions(const AdaptiveStepOptions &options)
+{
+    controller_.setAdaptiveOptions(options);
+}
+
+void SimulationModel::setKeplerCoast(bool enabled, double threshold)
+{
+    controller_.setKeplerCoast(enabled, threshold);
+}
+
+bool SimulationModel::isCoasting() const
+{
+    return controller_.isCoasting();
+}
+
+bool SimulationModel::canCoast(double stepSeconds) const
+{
+    // The same field advance() would build, with the planets where the step ends.
+    const double jupiterAngle = jupiterAngle_ + jupiterAngularSpeed_ * stepSeconds;
+    const double earthAngle = earthAngle_ + earthAngularSpeed_ * stepSeconds;
+
+    PointMassField field;
+    field.add(sun_);
+    field.add(Vector2(jupiterOrbitRadius_ * std::cos(jupiterAngle), jupiterOrbitRadius_ * std::sin(jupiterAngle)), jupiter_.mu);
+    if (earth_.mu > 0.0)
+    {
+        field.add(Vector2(earthOrbitRadius_ * std::cos(earthAngle), earthOrbitRadius_ * std::sin(earthAngle)), earth_.mu);
+    }
+    return controller_.canCoast(field);
+}
+
+const AdaptiveStepStats& SimulationModel::adaptiveStats() const
+{
+    return controller_.adaptiveStats();
 }
 
 double SimulationModel::timeScale() const
@@ -250,6 +293,69 @@ void SimulationModel::setTimeScale(double newTimeScale)
     }
 
     timeScale_ = newTimeScale;
+    keyframes_.truncate(clock_.time());
+}
+
+void SimulationModel::setTrailSink(TrailSampleQueue *sink)
+{
+    trailSink_ = sink;
+}
+
+TrajectoryBuffer& SimulationModel::trailFor(TrailBody body)
+{
+    switch (body)
+    {
+    case TrailBody::Earth:
+        return earthTrajectory_;
+    case TrailBody::Jupiter:
+        return jupiterTrajectory_;
+    case TrailBody::Ship:
+    default:
+        return trajectory_;
+    }
+}
+
+void SimulationModel::addTrailPoint(TrailBody body, const Vector2 &p)
+{
+    trailFor(body).addPoint(p);
+
+    if (trailSink_)
+    {
+        TrailSample sample;
+        sample.position = p;
+        sample.time = clock_.time();
+        sample.body = body;
+        sample.kind = TrailSampleKind::Point;
+        trailSink_->push(sample);
+    }
+}
+
+void SimulationModel::addTrailBreak(TrailBody body)
+{
+    trailFor(body).addBreak();
+
+    if (trailSink_)
+    {
+        TrailSample sample;
+        sample.time = clock_.time();
+        sample.body = body;
+        sample.kind = TrailSampleKind::Break;
+        trailSink_->push(sample);
+    }
+}
+
+void SimulationModel::clearTrail(TrailBody body)
+{
+    trailFor(body).clear();
+
+    if (trailSink_)
+    {
+        TrailSample sample;
+        sample.time = clock_.time();
+        sample.body = body;
+        sample.kind = TrailSampleKind::Clear;
+        trailSink_->push(sample);
+    }
 }
 
 SimulationModel::AssistPlanetRefs SimulationModel::assistPlanetRefsForIndex(int index)
@@ -261,6 +367,7 @@ SimulationModel::AssistPlanetRefs SimulationModel::assistPlanetRefsForIndex(int
         refs.angle = &earthAngle_;
         refs.orbitRadius = &earthOrbitRadius_;
         refs.angularSpeed = &earthAngularSpeed_;
+        refs.phase = &earthPhase_;
         return refs;
     }
 
@@ -269,5 +376,175 @@ SimulationModel::AssistPlanetRefs SimulationModel::assistPlanetRefsForIndex(int
     refs.angle = &jupiterAngle_;
     refs.orbitRadius = &jupiterOrbitRadius_;
     refs.angularSpeed = &jupiterAngularSpeed_;
+    refs.phase = &jupiterPhase_;
     return refs;
-}
\ No newline at end of file
+}
+
+void SimulationModel::setSunMu(double mu)
+{
+    if (mu <= 0.0)
+    {
+        return;
+    }
+
+    sun_.mu = mu;
+    controller_.setMu(mu);
+    updateAngularSpeeds();
+    keyframes_.truncate(clock_.time());
+}
+
+void SimulationModel::setPlanet(int planetIndex, double mu, double radius, double orbitRadius, double phase)
+{
+    AssistPlanetRefs planet = assistPlanetRefsForIndex(planetIndex);
+
+    if (mu > 0.0)
+    {
+        planet.body->mu = mu;
+    }
+    if (radius > 0.0)
+    {
+        planet.body->radius = radius;
+    }
+    if (orbitRadius > 0.0)
+    {
+        *planet.orbitRadius = orbitRadius;
+    }
+    *planet.phase = phase;
+
+    updateAngularSpeeds();
+    keyframes_.truncate(clock_.time());
+}
+
+void SimulationModel::updateAngularSpeeds()
+{
+    jupiterAngularSpeed_ = std::sqrt(sun_.mu / (jupiterOrbitRadius_ * jupiterOrbitRadius_ * jupiterOrbitRadius_));
+    earthAngularSpeed_ = std::sqrt(sun_.mu / (earthOrbitRadius_ * earthOrbitRadius_ * earthOrbitRadius_));
+}
+
+SimulationCheckpoint SimulationModel::checkpoint(bool includeTrails) const
+{
+    SimulationCheckpoint c;
+    c.controller = controller_.checkpoint();
+    c.time = clock_.time();
+    c.timeScale = timeScale_;
+
+    c.sun = sun_;
+    c.jupiter = jupiter_;
+    c.earth = earth_;
+
+    c.jupiterAngle = jupiterAngle_;
+    c.jupiterOrbitRadius = jupiterOrbitRadius_;
+    c.jupiterAngularSpeed = jupiterAngularSpeed_;
+    c.jupiterPhase = jupiterPhase_;
+    c.earthAngle = earthAngle_;
+    c.earthOrbitRadius = earthOrbitRadius_;
+    c.earthAngularSpeed = earthAngularSpeed_;
+    c.earthPhase = earthPhase_;
+
+    c.trailBreakPending = trailBreakPending_;
+
+    if (includeTrails)
+    {
+        const auto copyTrail = [](const TrajectoryBuffer &trail, std::vector<Vector2> &out)
+        {
+            const TrajectoryBuffer::Segments segments = trail.segments();
+            out.reserve(segments.size());
+            out.assign(segments.first.begin(), segments.first.end());
+            out.insert(out.end(), segments.second.begin(), segments.second.end());
+        };
+
+        c.hasTrails = true;
+        copyTrail(trajectory_, c.shipTrail);
+        copyTrail(jupiterTrajectory_, c.jupiterTrail);
+        copyTrail(earthTrajectory_, c.earthTrail);
+    }
+
+    return c;
+}
+
+void SimulationModel::restore(const SimulationCheckpoint &c)
+{
+    restoreState(c);
+
+    keyframes_.clear();
+    addKeyframe();
+
+    // Trails go through the usual helpers so a trail sink stays in sync.
+    if (c.hasTrails)
+    {
+        const auto restoreTrail = [this](TrailBody body, const std::vector<Vector2> &points)
+        {
+            clearTrail(body);
+            for (const Vector2 &p : points)
+            {
+                addTrailPoint(body, p);
+            }
+        };
+
+        restoreTrail(TrailBody::Ship, c.shipTrail);
+        restoreTrail(TrailBody::Jupiter, c.jupiterTrail);
+        restoreTrail(TrailBody::Earth, c.earthTrail);
+        return;
+    }
+
+    trailBreakPending_ = true;
+    recordTrailPoints();
+}
+
+void SimulationModel::restoreState(const SimulationCheckpoint &c)
+{
+    controller_.restore(c.controller);
+    clock_.reset(c.time);
+    timeScale_ = c.timeScale;
+
+    sun_ = c.sun;
+    jupiter_ = c.jupiter;
+    earth_ = c.earth;
+
+    jupiterAngle_ = c.jupiterAngle;
+    jupiterOrbitRadius_ = c.jupiterOrbitRadius;
+    jupiterAngularSpeed_ = c.jupiterAngularSpeed;
+    jupiterPhase_ = c.jupiterPhase;
+    earthAngle_ = c.earthAngle;
+    earthOrbitRadius_ = c.earthOrbitRadius;
+    earthAngularSpeed_ = c.earthAngularSpeed;
+    earthPhase_ = c.earthPhase;
+
+    trailBreakPending_ = c.trailBreakPending;
+}
+
+void SimulationModel::setKeyframeInterval(std::size_t steps)
+{
+    keyframes_.setInterval(steps);
+}
+
+const KeyframeIndex& SimulationModel::keyframes() const
+{
+    return keyframes_;
+}
+
+void SimulationModel::addKeyframe()
+{
+    keyframes_.add(checkpoint());
+}
+
+bool SimulationModel::seek(double time)
+{
+    const KeyframeIndex::Keyframe *keyframe = keyframes_.find(time);
+    if (keyframe == nullptr)
+    {
+        return false;
+    }
+
+    restoreState(keyframe->state);
+    keyframes_.rewind(*keyframe);
+
+    // Replays the logged steps, so the state matches the recording exactly.
+    for (double step = keyframes_.nextStep(); step > 0.0 && clock_.time() + step <= time; step = keyframes_.nextStep())
+    {
+        advance(step);
+    }
+
+    trailBreakPending_ = true;
+    return true;
+}
@@ -2,8 +2,11 @@
 
 #include <vector>
 #include "SimulationController.h"
+#include "SimulationCheckpoint.h"
 #include "SimulationClock.h"
+#include "KeyframeIndex.h"
 #include "TrajectoryBuffer.h"
+#include "TrailSampleQueue.h"
 #include "ScenarioParams.h"
 #include "../core/Body.h"
 #include "../core/MathUtils.h"
@@ -21,25 +24,33 @@ public:
         IntegratorType integratorType = IntegratorType::RK4, 
         std::size_t trajectoryMaxSize = 5000);
 
+    // One step of dt * timeScale, then one trail point per body.
     void update();
 
+    // Advances the simulation by stepSeconds of simulated time without
+    // touching the trails (used by SimulationScheduler for sub-steps).
+    void advance(double stepSeconds);
+
+    // Appends the current ship, Earth and Jupiter positions to their trails.
+    void recordTrailPoints();
+
     void reset(const ScenarioParams &params);
 
     const State2& state() const;
 
     double time() const;
 
-    const std::vector<Vector2>& trajectory() const;
+    const TrajectoryBuffer& trajectory() const;
 
     const Body& sun() const;
     const Vector2& sunPosition() const;
 
     const Body& jupiter() const;
     const Vector2& jupiterPosition() const;
-    const std::vector<Vector2>& jupiterTrajectory() const;
+    const TrajectoryBuffer& jupiterTrajectory() const;
 
     const Vector2& earthPosition() const;
-    const std::vector<Vector2>& earthTrajectory() const;
+    const TrajectoryBuffer& earthTrajectory() const;
 
     double dt() const;
     void setDt(double newDt);
@@ -51,7 +62,57 @@ public:
 
     void setIntegrator(IntegratorType type);
 
+    void setAdaptiveOptions(const AdaptiveStepOptions &options);
+
+    // Body parameters, applied at the next reset(). planetIndex is 0 for
+    // Jupiter and 1 for Earth (as ScenarioParams::assistPlanetIndex); a zero
+    // mu, radius or orbitRadius keeps the current value. Planets move on
+    // circular orbits and are at angle `phase` [rad] at epoch 0. Earth only
+    // attracts the ship once it has a mu.
+    void setSunMu(double mu);
+    void setPlanet(int planetIndex, double mu, double radius, double orbitRadius, double phase);
+
+    // See SimulationController::setKeplerCoast(); the Sun is the primary.
+    void setKeplerCoast(bool enabled, double threshold = 1e-4);
+    bool isCoasting() const;
+    // Whether a step of `stepSeconds` taken now would be coasted.
+    bool canCoast(double stepSeconds) const;
+    const AdaptiveStepStats& adaptiveStats() const;
+
+    // Every trail change (point, break, clear) is also pushed to `sink` if set,
+    // so another thread can mirror the trails. The queue is not owned.
+    void setTrailSink(TrailSampleQueue *sink);
+
+    // Snapshot for crash recovery or forking a run. After restore() the model
+    // steps bit-identically to the one the checkpoint was taken from. Trail
+    // capacities are not part of it; without trails, restore() keeps the
+    // current trails and starts a new segment at the restored positions.
+    SimulationCheckpoint checkpoint(bool includeTrails = false) const;
+    void restore(const SimulationCheckpoint &checkpoint);
+
+    // Keyframes are recorded every `steps` steps (0 = off) for seek().
+    // Resetting or restoring starts a new recording; changing dt, time scale,
+    // mu or the integrator ends the current one at the current time.
+    void setKeyframeInterval(std::size_t steps);
+    const KeyframeIndex& keyframes() const;
+
+    // Moves the model to the last recorded step at or before `time`: restores
+    // the keyframe before it (including the dt and time scale in use then) and
+    // replays the recorded steps. The trails are left alone; the next recorded
+    // point starts a new segment. Stepping on from there keeps the rest of the
+    // recording as long as the steps match it (see KeyframeIndex). Returns
+    // false if no keyframe precedes `time`.
+    bool seek(double time);
+
 private:
+    void restoreState(const SimulationCheckpoint &checkpoint);
+    void addKeyframe();
+
+    TrajectoryBuffer& trailFor(TrailBody body);
+    void addTrailPoint(TrailBody body, const Vector2 &p);
+    void addTrailBreak(TrailBody body);
+    void clearTrail(TrailBody body);
+
     SimulationController controller_;
     SimulationClock clock_;
     TrajectoryBuffer trajectory_;
@@ -63,6 +124,7 @@ private:
     double jupiterAngle_ = 0.0;
     double jupiterOrbitRadius_ = 5.204* AU_KM;
     double jupiterAngularSpeed_ = 0.0;
+    double jupiterPhase_ = 0.0;
     TrajectoryBuffer jupiterTrajectory_;
 
     Body earth_;
@@ -70,6 +132,7 @@ private:
     double earthAngle_ = 0.0;
     double earthOrbitRadius_ = 1.0 * AU_KM;
     double earthAngularSpeed_ = 0.0;
+    double earthPhase_ = 0.0;
     TrajectoryBuffer earthTrajectory_;
 
     struct AssistPlanetRefs
@@ -78,7 +141,15 @@ private:
         double* angle = nullptr;
         double* orbitRadius = nullptr;
         double* angularSpeed = nullptr;
+        double* phase = nullptr;
     };
 
+    void updateAngularSpeeds();
+
     AssistPlanetRefs assistPlanetRefsForIndex(int index);
-};
\ No newline at end of file
+
+    TrailSampleQueue *trailSink_ = nullptr;
+    bool trailBreakPending_ = false;
+
+    KeyframeIndex keyframes_;
+};
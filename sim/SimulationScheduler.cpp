@@ -0,0 +1,110 @@
+#include "SimulationScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include "SimulationModel.h"
+
+SimulationScheduler::SimulationScheduler(const SchedulerSettings &settings)
+    : settings_(settings)
+{
+}
+
+SchedulerReport SimulationScheduler::advance(SimulationModel &model, double wallSeconds)
+{
+    using Clock = std::chrono::steady_clock;
+
+    SchedulerReport report;
+
+    if (wallSeconds < 0.0 || settings_.maxStep <= 0.0)
+    {
+        lastReport_ = report;
+        return report;
+    }
+
+    accumulator_ += wallSeconds * settings_.simSecondsPerWallSecond;
+
+    const double maxOwed = settings_.maxBacklog * settings_.simSecondsPerWallSecond;
+    if (accumulator_ > maxOwed + settings_.maxStep)
+    {
+        report.dropped = accumulator_ - maxOwed;
+        accumulator_ = maxOwed;
+    }
+
+    // Reading the clock every step would cost more than a step, so check it in batches.
+    const std::uint64_t clockCheckInterval = 16;
+    const Clock::time_point start = Clock::now();
+
+    // Checked for the step about to be taken, not the last one: the previous
+    // step may have coasted while the next one starts inside a perturbation.
+    const double stretched = std::min(settings_.trailInterval, settings_.maxCoastStretch * settings_.maxStep);
+    const auto stepSize = [this, &model, stretched]()
+    {
+        if (settings_.stretchWhileCoasting && stretched > settings_.maxStep && model.canCoast(stretched))
+        {
+            return stretched;
+        }
+        return settings_.maxStep;
+    };
+
+    double h = stepSize();
+
+    while (accumulator_ >= h)
+    {
+        model.advance(h);
+        accumulator_ -= h;
+        report.simulated += h;
+        ++report.steps;
+
+        sinceTrail_ += h;
+        if (sinceTrail_ >= settings_.trailInterval)
+        {
+            model.recordTrailPoints();
+            sinceTrail_ = (settings_.trailInterval > 0.0) ? sinceTrail_ - settings_.trailInterval : 0.0;
+
+            // Never owe more than one sample; a slow trail rate must not produce bursts.
+            if (sinceTrail_ >= settings_.trailInterval)
+            {
+                sinceTrail_ = 0.0;
+            }
+        }
+
+        if (report.steps % clockCheckInterval == 0)
+        {
+            const double used = std::chrono::duration<double>(Clock::now() - start).count();
+            if (used >= settings_.cpuBudget)
+            {
+                break;
+            }
+        }
+
+        h = stepSize();
+    }
+
+    report.backlog = accumulator_;
+    report.fallingBehind = accumulator_ >= h;
+
+    lastReport_ = report;
+    return report;
+}
+
+void SimulationScheduler::reset()
+{
+    accumulator_ = 0.0;
+    sinceTrail_ = 0.0;
+    lastReport_ = SchedulerReport();
+}
+
+const SchedulerSettings& SimulationScheduler::settings() const
+{
+    return settings_;
+}
+
+void SimulationScheduler::setSettings(const SchedulerSettings &settings)
+{
+    settings_ = settings;
+}
+
+const SchedulerReport& SimulationScheduler::lastReport() const
+{
+    return lastReport_;
+}
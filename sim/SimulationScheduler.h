@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+
+class SimulationModel;
+
+struct SchedulerSettings
+{
+    double simSecondsPerWallSecond = 1.5768e7; // target speed (default 0.5 yr/s)
+    double maxStep = 86400.0;                  // largest physical step [s]
+    double cpuBudget = 0.010;                  // wall seconds of stepping allowed per frame
+    double trailInterval = 0.0;                // sim seconds between trail samples (0 = every step)
+    double maxBacklog = 1.0;                   // wall seconds of backlog kept before it is dropped
+    bool stretchWhileCoasting = true;          // coasted steps are exact, so they may exceed maxStep
+    double maxCoastStretch = 8.0;              // a stretched step is at most this many maxSteps
+};
+
+struct SchedulerReport
+{
+    std::uint64_t steps = 0;     // physical sub-steps taken this frame
+    double simulated = 0.0;      // sim seconds advanced this frame
+    double backlog = 0.0;        // sim seconds still owed after this frame
+    double dropped = 0.0;        // sim seconds given up because the backlog grew too large
+    bool fallingBehind = false;  // the CPU budget ran out before the backlog was cleared
+};
+
+// Real-time fixed-timestep driver for SimulationModel.
+//
+// Each frame the wall time since the previous frame is converted into
+// simulated time at simSecondsPerWallSecond and added to an accumulator,
+// which is then consumed in fixed steps of maxStep (the remainder carries
+// over). Speed and accuracy are therefore independent: the speed only changes
+// how many steps run per frame, never their size. Stepping stops when the CPU
+// budget for the frame is used up; the rest stays in the backlog and the
+// report flags that the simulation is falling behind. Trail points are
+// recorded every trailInterval of simulated time, independent of the step size.
+// When the next step would be coasted on a Kepler arc it is exact, so it grows
+// to the trail interval (if that is larger, up to maxCoastStretch steps) and
+// long cruises cost little. The coast condition is only checked at the start
+// of the step, so the cap bounds how far a stretched step can run into a
+// perturbation.
+class SimulationScheduler
+{
+public:
+    explicit SimulationScheduler(const SchedulerSettings &settings = SchedulerSettings());
+
+    SchedulerReport advance(SimulationModel &model, double wallSeconds);
+
+    // Forgets the backlog and the trail sampling phase (after a model reset).
+    void reset();
+
+    const SchedulerSettings& settings() const;
+    void setSettings(const SchedulerSettings &settings);
+
+    const SchedulerReport& lastReport() const;
+
+private:
+    SchedulerSettings settings_;
+    SchedulerReport lastReport_;
+
+    double accumulator_ = 0.0;   // sim seconds owed
+    double sinceTrail_ = 0.0;    // sim seconds since the last trail point
+};
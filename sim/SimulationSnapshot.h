@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include "../core/State2.h"
+#include "../core/Vector2.h"
+#include "SimulationScheduler.h"
+
+// Immutable view of the simulation published by SimulationWorker.
+// Trail points are delivered separately through the worker's TrailSampleQueue.
+struct SimulationSnapshot
+{
+    State2 state;
+    double time = 0.0;
+    double dt = 0.0;
+    double timeScale = 0.0;
+
+    Vector2 sunPosition;
+    Vector2 earthPosition;
+    Vector2 jupiterPosition;
+
+    std::uint64_t steps = 0; // steps taken by the worker so far
+
+    // Range SimulationWorker::seek() can reach.
+    double seekStart = 0.0;
+    double seekEnd = 0.0;
+
+    SchedulerReport scheduler; // last scheduled frame, if the scheduler is enabled
+};
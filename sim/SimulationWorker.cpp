@@ -0,0 +1,302 @@
+#include "SimulationWorker.h"
+
+#include <chrono>
+#include <utility>
+
+SimulationWorker::SimulationWorker(const SimulationModel &model, double stepsPerSecond)
+    : model_(model),
+      stepsPerSecond_(stepsPerSecond > 0.0 ? stepsPerSecond : 50.0)
+{
+    // Trails already in the model are the reader's starting point; only
+    // changes from here on go through the queue.
+    model_.setTrailSink(&trailQueue_);
+
+    thread_ = std::thread(&SimulationWorker::run, this);
+}
+
+SimulationWorker::~SimulationWorker()
+{
+    if (thread_.joinable())
+    {
+        stop();
+    }
+}
+
+SimulationModel SimulationWorker::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(commandMutex_);
+        stopRequested_ = true;
+    }
+    commandSignal_.notify_one();
+
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+
+    model_.setTrailSink(nullptr);
+    return std::move(model_);
+}
+
+void SimulationWorker::reset(const ScenarioParams &params)
+{
+    post(ResetCommand{ params });
+}
+
+void SimulationWorker::setDt(double newDt)
+{
+    post(DtCommand{ newDt });
+}
+
+void SimulationWorker::setTimeScale(double newTimeScale)
+{
+    post(TimeScaleCommand{ newTimeScale });
+}
+
+void SimulationWorker::setMu(double newMu)
+{
+    post(MuCommand{ newMu });
+}
+
+void SimulationWorker::setIntegrator(IntegratorType type)
+{
+    post(IntegratorCommand{ type });
+}
+
+void SimulationWorker::setPaused(bool paused)
+{
+    post(PauseCommand{ paused });
+}
+
+void SimulationWorker::setStepRate(double stepsPerSecond)
+{
+    post(StepRateCommand{ stepsPerSecond });
+}
+
+void SimulationWorker::setScheduler(bool enabled, const SchedulerSettings &settings)
+{
+    post(SchedulerCommand{ enabled, settings });
+}
+
+void SimulationWorker::seek(double time)
+{
+    post(SeekCommand{ time });
+}
+
+const SimulationSnapshot* SimulationWorker::takeSnapshot()
+{
+    std::uint8_t current = middle_.load(std::memory_order_acquire);
+    if ((current & freshBit) == 0)
+    {
+        return nullptr;
+    }
+
+    // Hand our old buffer back in exchange for the fresh one. If the worker
+    // reclaimed it in the meantime it will publish again shortly.
+    if (!middle_.compare_exchange_strong(current, front_, std::memory_order_acq_rel))
+    {
+        return nullptr;
+    }
+
+    front_ = current & indexMask;
+    return &buffers_[front_];
+}
+
+TrailSampleQueue& SimulationWorker::trailQueue()
+{
+    return trailQueue_;
+}
+
+void SimulationWorker::post(Command command)
+{
+    {
+        std::lock_guard<std::mutex> lock(commandMutex_);
+        commands_.push_back(std::move(command));
+    }
+    commandSignal_.notify_one();
+}
+
+void SimulationWorker::run()
+{
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point rateStart = Clock::now();
+    std::uint64_t stepsSinceRateStart = 0;
+    double rate = stepsPerSecond_;
+    bool wasPaused = paused_;
+    bool wasScheduled = schedulerEnabled_;
+
+    publish();
+
+    while (!stopRequested_)
+    {
+        const bool changed = applyCommands();
+
+        // Pausing or changing the rate restarts the schedule instead of catching up.
+        if (rate != stepsPerSecond_ || wasPaused != paused_ || wasScheduled != schedulerEnabled_)
+        {
+            rate = stepsPerSecond_;
+            wasPaused = paused_;
+            wasScheduled = schedulerEnabled_;
+            rateStart = Clock::now();
+            stepsSinceRateStart = 0;
+        }
+
+        bool stepped = false;
+
+        if (!paused_ && schedulerEnabled_)
+        {
+            // One frame per tick; the scheduler turns the wall time since the
+            // previous frame into as many sub-steps as its budget allows.
+            const Clock::time_point now = Clock::now();
+            const std::uint64_t due = static_cast<std::uint64_t>(
+                std::chrono::duration<double>(now - rateStart).count() * rate);
+
+            if (due > stepsSinceRateStart)
+            {
+                const double wallSeconds = static_cast<double>(due - stepsSinceRateStart) / rate;
+                const SchedulerReport report = scheduler_.advance(model_, wallSeconds);
+
+                steps_ += report.steps;
+                stepsSinceRateStart = due;
+                stepped = true;
+            }
+        }
+        else if (!paused_)
+        {
+            const double elapsed = std::chrono::duration<double>(Clock::now() - rateStart).count();
+            const std::uint64_t due = static_cast<std::uint64_t>(elapsed * rate);
+
+            // Never try to catch up on more than a quarter of a second of backlog.
+            const std::uint64_t maxBacklog = static_cast<std::uint64_t>(rate * 0.25) + 1;
+            if (due > stepsSinceRateStart + maxBacklog)
+            {
+                stepsSinceRateStart = due - maxBacklog;
+            }
+
+            while (stepsSinceRateStart < due && !stopRequested_)
+            {
+                model_.update();
+                ++steps_;
+                ++stepsSinceRateStart;
+                stepped = true;
+            }
+        }
+
+        if (changed || stepped)
+        {
+            publish();
+        }
+
+        std::unique_lock<std::mutex> lock(commandMutex_);
+        const auto wakeUp = [this]() { return !commands_.empty() || stopRequested_; };
+
+        if (paused_)
+        {
+            commandSignal_.wait(lock, wakeUp);
+        }
+        else
+        {
+            const auto nextStep = rateStart + std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(static_cast<double>(stepsSinceRateStart + 1) / rate));
+            commandSignal_.wait_until(lock, nextStep, wakeUp);
+        }
+    }
+}
+
+bool SimulationWorker::applyCommands()
+{
+    {
+        std::lock_guard<std::mutex> lock(commandMutex_);
+        commandsInFlight_.swap(commands_);
+    }
+
+    if (commandsInFlight_.empty())
+    {
+        return false;
+    }
+
+    for (const Command &command : commandsInFlight_)
+    {
+        apply(command);
+    }
+
+    commandsInFlight_.clear();
+    return true;
+}
+
+void SimulationWorker::apply(const Command &command)
+{
+    if (const ResetCommand *c = std::get_if<ResetCommand>(&command))
+    {
+        model_.reset(c->params);
+        scheduler_.reset();
+    }
+    else if (const DtCommand *c = std::get_if<DtCommand>(&command))
+    {
+        model_.setDt(c->dt);
+    }
+    else if (const TimeScaleCommand *c = std::get_if<TimeScaleCommand>(&command))
+    {
+        model_.setTimeScale(c->timeScale);
+    }
+    else if (const MuCommand *c = std::get_if<MuCommand>(&command))
+    {
+        model_.setMu(c->mu);
+    }
+    else if (const IntegratorCommand *c = std::get_if<IntegratorCommand>(&command))
+    {
+        model_.setIntegrator(c->type);
+    }
+    else if (const PauseCommand *c = std::get_if<PauseCommand>(&command))
+    {
+        paused_ = c->paused;
+    }
+    else if (const StepRateCommand *c = std::get_if<StepRateCommand>(&command))
+    {
+        if (c->stepsPerSecond > 0.0)
+        {
+            stepsPerSecond_ = c->stepsPerSecond;
+        }
+    }
+    else if (const SchedulerCommand *c = std::get_if<SchedulerCommand>(&command))
+    {
+        if (c->enabled != schedulerEnabled_)
+        {
+            scheduler_.reset();
+        }
+
+        schedulerEnabled_ = c->enabled;
+        scheduler_.setSettings(c->settings);
+    }
+    else if (const SeekCommand *c = std::get_if<SeekCommand>(&command))
+    {
+        model_.seek(c->time);
+        scheduler_.reset();
+    }
+}
+
+void SimulationWorker::publish()
+{
+    // Take the buffer sitting in the middle slot, leaving our spare there.
+    // Whether or not the reader saw it, it is overwritten with newer data.
+    const std::uint8_t claimed = middle_.exchange(back_, std::memory_order_acq_rel);
+    const std::uint8_t index = claimed & indexMask;
+    SimulationSnapshot &s = buffers_[index];
+
+    s.state = model_.state();
+    s.time = model_.time();
+    s.dt = model_.dt();
+    s.timeScale = model_.timeScale();
+    s.sunPosition = model_.sunPosition();
+    s.earthPosition = model_.earthPosition();
+    s.jupiterPosition = model_.jupiterPosition();
+    s.steps = steps_;
+    s.seekStart = model_.keyframes().startTime();
+    s.seekEnd = model_.keyframes().endTime();
+    s.scheduler = scheduler_.lastReport();
+
+    // The reader only swaps out fresh buffers, so this returns our spare.
+    back_ = middle_.exchange(static_cast<std::uint8_t>(index | freshBit), std::memory_order_acq_rel) & indexMask;
+}
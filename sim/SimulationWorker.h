@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <variant>
+#include <vector>
+#include "SimulationModel.h"
+#include "SimulationScheduler.h"
+#include "SimulationSnapshot.h"
+#include "TrailSampleQueue.h"
+
+// Runs a SimulationModel on its own thread.
+//
+// The worker owns the model and steps it at a fixed rate (steps per wall-clock
+// second), independently of the GUI. After each batch of steps it publishes a
+// SimulationSnapshot; the reader picks up the newest one with takeSnapshot(),
+// which only swaps a buffer index. Trail samples recorded by the model go
+// through trailQueue(), which the reader drains into its own trail storage.
+// Commands (reset, dt, time scale, ...) are queued as messages and applied by
+// the worker between steps, so the model is never shared between threads.
+// With the scheduler enabled the step rate becomes a frame rate, and each
+// frame advances the model by wall-clock time through a SimulationScheduler.
+class SimulationWorker
+{
+public:
+    explicit SimulationWorker(const SimulationModel &model, double stepsPerSecond = 50.0);
+    ~SimulationWorker();
+
+    SimulationWorker(const SimulationWorker&) = delete;
+    SimulationWorker& operator=(const SimulationWorker&) = delete;
+
+    // Stops the thread and hands the model back. The worker is unusable afterwards.
+    SimulationModel stop();
+
+    void reset(const ScenarioParams &params);
+    void setDt(double newDt);
+    void setTimeScale(double newTimeScale);
+    void setMu(double newMu);
+    void setIntegrator(IntegratorType type);
+    void setPaused(bool paused);
+    void setStepRate(double stepsPerSecond);
+    void setScheduler(bool enabled, const SchedulerSettings &settings);
+    void seek(double time);
+
+    // Returns the newest snapshot if one was published since the previous call,
+    // nullptr otherwise. The snapshot stays valid until the next call.
+    // Must only be called from one (reader) thread.
+    const SimulationSnapshot* takeSnapshot();
+
+    // Trail samples produced by the model; drain() from the reader thread.
+    TrailSampleQueue& trailQueue();
+
+private:
+    struct ResetCommand { ScenarioParams params; };
+    struct DtCommand { double dt; };
+    struct TimeScaleCommand { double timeScale; };
+    struct MuCommand { double mu; };
+    struct IntegratorCommand { IntegratorType type; };
+    struct PauseCommand { bool paused; };
+    struct StepRateCommand { double stepsPerSecond; };
+    struct SchedulerCommand { bool enabled; SchedulerSettings settings; };
+    struct SeekCommand { double time; };
+
+    using Command = std::variant<ResetCommand, DtCommand, TimeScaleCommand, MuCommand,
+                                 IntegratorCommand, PauseCommand, StepRateCommand,
+                                 SchedulerCommand, SeekCommand>;
+
+    void post(Command command);
+    void run();
+    bool applyCommands(); // returns whether any command was applied
+    void apply(const Command &command);
+    void publish();
+
+    SimulationModel model_;
+
+    // Worker-only state
+    double stepsPerSecond_;
+    bool paused_ = false;
+    std::uint64_t steps_ = 0;
+    SimulationScheduler scheduler_;
+    bool schedulerEnabled_ = false;
+
+    TrailSampleQueue trailQueue_;
+
+    // Command queue
+    std::mutex commandMutex_;
+    std::condition_variable commandSignal_;
+    std::vector<Command> commands_;
+    std::vector<Command> commandsInFlight_; // worker-side swap target
+
+    // Snapshot triple buffer: the worker fills one buffer, the reader holds one,
+    // and the third sits in `middle_`. freshBit marks a published, unread buffer.
+    static constexpr std::uint8_t freshBit = 0x4;
+    static constexpr std::uint8_t indexMask = 0x3;
+
+    SimulationSnapshot buffers_[3];
+    std::atomic<std::uint8_t> middle_{1};
+    std::uint8_t back_ = 0;   // worker
+    std::uint8_t front_ = 2;  // reader
+
+    std::atomic<bool> stopRequested_{false};
+    std::thread thread_;
+};
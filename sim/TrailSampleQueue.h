@@ -0,0 +1,222 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../core/Vector2.h"
+
+enum class TrailBody : std::uint8_t
+{
+    Ship,
+    Earth,
+    Jupiter,
+    Count
+};
+
+enum class TrailSampleKind : std::uint8_t
+{
+    Point,  // a new trail point
+    Break,  // trail interrupted (TrajectoryBuffer::addBreak)
+    Clear   // trail cleared (TrajectoryBuffer::clear)
+};
+
+struct TrailSample
+{
+    Vector2 position;
+    double time = 0.0;
+    TrailBody body = TrailBody::Ship;
+    TrailSampleKind kind = TrailSampleKind::Point;
+};
+
+// Bounded, wait-free single-producer/single-consumer queue of trail samples.
+//
+// The ring is allocated once; push() and drain() never allocate or lock.
+// push() may only be called from the producer thread and drain() only from the
+// consumer thread; the counters may be read from either.
+//
+// Overflow policy: when the ring is full the new sample is dropped and counted
+// in dropped(). Points are simply lost (the consumer's trail gets a straight
+// gap). A dropped Break or Clear is latched per body and re-sent ahead of the
+// next sample that fits; points of that body are dropped until it is, so the
+// consumer never joins across a reset.
+class TrailSampleQueue
+{
+public:
+    explicit TrailSampleQueue(std::size_t capacity = 65536)
+    {
+        std::size_t size = 2;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+
+        ring_.resize(size);
+        mask_ = size - 1;
+
+        for (TrailSampleKind &pending : pending_)
+        {
+            pending = TrailSampleKind::Point;
+        }
+    }
+
+    TrailSampleQueue(const TrailSampleQueue&) = delete;
+    TrailSampleQueue& operator=(const TrailSampleQueue&) = delete;
+
+    // Producer side. Returns false if the sample was dropped.
+    bool push(const TrailSample &sample)
+    {
+        flushPending();
+
+        // A point must not overtake a latched Break/Clear of its body that
+        // still did not fit, or the consumer would join it across the reset.
+        if (sample.kind == TrailSampleKind::Point && hasPending_
+            && pending_[static_cast<std::size_t>(sample.body)] != TrailSampleKind::Point)
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        if (!tryPush(sample))
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+
+            if (sample.kind != TrailSampleKind::Point)
+            {
+                latch(sample);
+            }
+            return false;
+        }
+
+        return true;
+    }
+
+    // Consumer side. Calls fn(const TrailSample&) for every queued sample in
+    // order and returns how many were consumed.
+    template <typename Fn>
+    std::size_t drain(Fn &&fn)
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+
+        for (std::size_t i = head; i != tail; ++i)
+        {
+            fn(ring_[i & mask_]);
+        }
+
+        head_.store(tail, std::memory_order_release);
+        return tail - head;
+    }
+
+    std::size_t capacity() const
+    {
+        return ring_.size();
+    }
+
+    // Samples currently waiting for the consumer.
+    std::size_t backlog() const
+    {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    // Largest backlog seen by the producer.
+    std::size_t maxBacklog() const
+    {
+        return maxBacklog_.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t dropped() const
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    bool tryPush(const TrailSample &sample)
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+
+        if (tail - cachedHead_ >= ring_.size())
+        {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ >= ring_.size())
+            {
+                return false;
+            }
+        }
+
+        ring_[tail & mask_] = sample;
+        tail_.store(tail + 1, std::memory_order_release);
+
+        const std::size_t backlog = tail + 1 - cachedHead_;
+        if (backlog > maxBacklog_.load(std::memory_order_relaxed))
+        {
+            maxBacklog_.store(backlog, std::memory_order_relaxed);
+        }
+
+        return true;
+    }
+
+    void latch(const TrailSample &sample)
+    {
+        TrailSampleKind &pending = pending_[static_cast<std::size_t>(sample.body)];
+
+        // A clear supersedes a break.
+        if (pending != TrailSampleKind::Clear)
+        {
+            pending = sample.kind;
+            pendingTime_[static_cast<std::size_t>(sample.body)] = sample.time;
+            hasPending_ = true;
+        }
+    }
+
+    void flushPending()
+    {
+        if (!hasPending_)
+        {
+            return;
+        }
+
+        hasPending_ = false;
+
+        for (std::size_t body = 0; body < pending_.size(); ++body)
+        {
+            if (pending_[body] == TrailSampleKind::Point)
+            {
+                continue;
+            }
+
+            TrailSample sample;
+            sample.body = static_cast<TrailBody>(body);
+            sample.kind = pending_[body];
+            sample.time = pendingTime_[body];
+
+            if (tryPush(sample))
+            {
+                pending_[body] = TrailSampleKind::Point;
+            }
+            else
+            {
+                hasPending_ = true;
+            }
+        }
+    }
+
+    static constexpr std::size_t cacheLine = 64;
+    static constexpr std::size_t bodyCount = static_cast<std::size_t>(TrailBody::Count);
+
+    std::vector<TrailSample> ring_;
+    std::size_t mask_ = 0;
+
+    // Written by the consumer
+    alignas(cacheLine) std::atomic<std::size_t> head_{0};
+
+    // Written by the producer
+    alignas(cacheLine) std::atomic<std::size_t> tail_{0};
+    std::atomic<std::size_t> maxBacklog_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::size_t cachedHead_ = 0;
+    bool hasPending_ = false;
+    std::array<TrailSampleKind, bodyCount> pending_;
+    std::array<double, bodyCount> pendingTime_{};
+};
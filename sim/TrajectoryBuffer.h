@@ -1,30 +1,72 @@
 #pragma once
 
 #include <vector>
+#include <span>
 #include <limits>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
 #include "../core/Vector2.h"
+#include "TrajectoryLod.h"
 
+// Fixed-capacity circular buffer of trajectory points.
+// Appending and evicting the oldest point are both O(1). The stored points
+// are exposed as one or two contiguous spans (oldest first), so readers can
+// iterate the whole history without copying it.
+// A TrajectoryLod pyramid is maintained alongside the points for rendering.
 class TrajectoryBuffer
 {
 public:
-    explicit TrajectoryBuffer(std::size_t maxSize = 1000000) : maxSize_(maxSize)
+    // View over the stored points in chronological order.
+    // When the ring has wrapped, `first` holds the older part and `second` the newer one.
+    struct Segments
+    {
+        std::span<const Vector2> first;
+        std::span<const Vector2> second;
+
+        std::size_t size() const
+        {
+            return first.size() + second.size();
+        }
+
+        bool empty() const
+        {
+            return first.empty() && second.empty();
+        }
+    };
+
+    explicit TrajectoryBuffer(std::size_t maxSize = 1000000) : maxSize_(maxSize), lod_(maxSize)
     {
     }
 
     void addPoint(const Vector2 &p)
     {
-        if (maxSize_ > 0 && points_.size() >= maxSize_)
+        lod_.add(totalAdded_, p);
+        ++totalAdded_;
+
+        // maxSize_ == 0 means the buffer is unbounded.
+        if (maxSize_ == 0 || points_.size() < maxSize_)
         {
-            points_.erase(points_.begin());
+            points_.push_back(p);
+            return;
         }
 
-        points_.push_back(p);
+        points_[head_] = p;
+        ++head_;
+        if (head_ == points_.size())
+        {
+            head_ = 0;
+        }
     }
 
     void clear()
     {
         points_.clear();
+        head_ = 0;
+        totalAdded_ = 0;
+        ++generation_;
+        lod_.clear();
     }
 
     void addBreak()
@@ -39,13 +81,116 @@ public:
         return std::isnan(p.x) || std::isnan(p.y);
     }
 
-    const std::vector<Vector2>& points() const
+    Segments segments() const
+    {
+        Segments result;
+        const std::span<const Vector2> all(points_.data(), points_.size());
+
+        result.first = all.subspan(head_);
+        result.second = all.first(head_);
+
+        return result;
+    }
+
+    // Calls fn(const Vector2&) for every stored point, oldest first.
+    template <typename Fn>
+    void forEach(Fn &&fn) const
+    {
+        const Segments segs = segments();
+
+        for (const Vector2 &p : segs.first)
+        {
+            fn(p);
+        }
+
+        for (const Vector2 &p : segs.second)
+        {
+            fn(p);
+        }
+    }
+
+    // Appends a copy of the trajectory simplified to `tolerance` (world units) to `out`,
+    // with break markers preserved. If `view` is given, history outside it is culled.
+    // Returns the number of culled points. See TrajectoryLod.
+    std::uint64_t simplify(double tolerance, const WorldRect *view, std::vector<Vector2> &out) const
+    {
+        TrajectoryLod::Query query;
+        query.tolerance = tolerance;
+        query.view = view;
+
+        return lod_.simplify(firstIndex(), endIndex(), query,
+                             [this](std::uint64_t i) -> const Vector2&
+                             {
+                                 return atIndex(i);
+                             },
+                             out);
+    }
+
+    void simplify(double tolerance, std::vector<Vector2> &out) const
+    {
+        simplify(tolerance, nullptr, out);
+    }
+
+    // Absolute indices count every point added since the last clear(); the oldest
+    // stored point has firstIndex(), the next point to be added gets endIndex().
+    std::uint64_t firstIndex() const
+    {
+        return totalAdded_ - points_.size();
+    }
+
+    std::uint64_t endIndex() const
+    {
+        return totalAdded_;
+    }
+
+    // Changes whenever absolute indices are renumbered (clear(), setMaxSize()),
+    // so readers that remember an index can tell it is no longer valid.
+    std::uint64_t generation() const
+    {
+        return generation_;
+    }
+
+    const Vector2& atIndex(std::uint64_t absoluteIndex) const
+    {
+        return (*this)[static_cast<std::size_t>(absoluteIndex - firstIndex())];
+    }
+
+    // Logical index: 0 is the oldest stored point.
+    const Vector2& operator[](std::size_t index) const
+    {
+        std::size_t physical = head_ + index;
+        if (physical >= points_.size())
+        {
+            physical -= points_.size();
+        }
+
+        return points_[physical];
+    }
+
+    const Vector2& back() const
+    {
+        return (head_ == 0) ? points_.back() : points_[head_ - 1];
+    }
+
+    std::size_t size() const
+    {
+        return points_.size();
+    }
+
+    bool empty() const
     {
-        return points_;
+        return points_.empty();
+    }
+
+    std::size_t maxSize() const
+    {
+        return maxSize_;
     }
 
     void setMaxSize(std::size_t newMaxSize)
     {
+        linearize();
+
         maxSize_ = newMaxSize;
 
         if (maxSize_ > 0 && points_.size() > maxSize_)
@@ -53,9 +198,33 @@ public:
             std::size_t excess = points_.size() - maxSize_;
             points_.erase(points_.begin(), points_.begin() + excess);
         }
+
+        // Rebuild the pyramid for the new capacity from the points that survived.
+        lod_.configure(maxSize_);
+        totalAdded_ = 0;
+        ++generation_;
+        for (const Vector2 &p : points_)
+        {
+            lod_.add(totalAdded_, p);
+            ++totalAdded_;
+        }
     }
 
 private:
+    // Rotates the storage so that the oldest point is at index 0.
+    void linearize()
+    {
+        if (head_ != 0)
+        {
+            std::rotate(points_.begin(), points_.begin() + head_, points_.end());
+            head_ = 0;
+        }
+    }
+
     std::vector<Vector2> points_;
+    std::size_t head_ = 0; // index of the oldest point once the ring is full
     std::size_t maxSize_;
-};
\ No newline at end of file
+    std::uint64_t totalAdded_ = 0; // points added since clear(); absolute index of the next point
+    std::uint64_t generation_ = 0;
+    TrajectoryLod lod_;
+};
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include "../core/Vector2.h"
+#include "../core/WorldRect.h"
+
+// Multi-resolution summary of a trajectory, built incrementally as points are appended.
+// Level l groups points into aligned buckets of 2^(baseShift + l) points and keeps
+// their bounding box (min/max) plus the first and last point. simplify() walks the
+// pyramid top-down and only descends into buckets that are larger than the requested
+// tolerance, so its cost depends on how many pixels the trajectory covers rather than
+// on how many points are stored. With a view rectangle, buckets lying entirely outside
+// it are reduced to their end points, so off-screen history costs almost nothing.
+//
+// Points are addressed by their absolute index (0 = first point added since clear()).
+// The pyramid is sized for a ring of `capacity` live points; buckets that fall out of
+// the live range are recycled.
+class TrajectoryLod
+{
+public:
+    struct Bucket
+    {
+        Vector2 min;
+        Vector2 max;
+        Vector2 first;
+        Vector2 last;
+        bool hasPoints = false;
+        bool hasBreak = false;   // bucket contains a break marker; never summarized
+    };
+
+    static constexpr unsigned baseShift = 3;          // finest level: 8 points per bucket
+    static constexpr std::size_t unboundedLevels = 20;
+
+    explicit TrajectoryLod(std::size_t capacity = 0)
+    {
+        configure(capacity);
+    }
+
+    // capacity == 0 means the trajectory is unbounded.
+    void configure(std::size_t capacity)
+    {
+        capacity_ = capacity;
+
+        std::size_t levelCount = unboundedLevels;
+        if (capacity_ > 0)
+        {
+            levelCount = 1;
+            while ((std::size_t(1) << (baseShift + levelCount - 1)) < capacity_)
+            {
+                ++levelCount;
+            }
+        }
+
+        levels_.assign(levelCount, Level());
+
+        for (std::size_t l = 0; l < levels_.size(); ++l)
+        {
+            if (capacity_ > 0)
+            {
+                // Enough slots for every bucket that can overlap the live range,
+                // rounded up to a power of two so the ring index is a mask.
+                const std::size_t needed = (capacity_ >> shiftForLevel(l)) + 2;
+                std::size_t slots = 1;
+                while (slots < needed)
+                {
+                    slots <<= 1;
+                }
+
+                levels_[l].slots = slots;
+                levels_[l].buckets.resize(slots);
+            }
+        }
+    }
+
+    void clear()
+    {
+        configure(capacity_);
+    }
+
+    void add(std::uint64_t index, const Vector2 &p)
+    {
+        const bool isBreak = std::isnan(p.x) || std::isnan(p.y);
+
+        for (std::size_t l = 0; l < levels_.size(); ++l)
+        {
+            const unsigned shift = shiftForLevel(l);
+            const std::uint64_t mask = (std::uint64_t(1) << shift) - 1;
+
+            Bucket &b = bucketForWrite(l, index >> shift);
+            if ((index & mask) == 0)
+            {
+                b = Bucket();
+            }
+
+            if (isBreak)
+            {
+                b.hasBreak = true;
+                continue;
+            }
+
+            if (!b.hasPoints)
+            {
+                b.min = p;
+                b.max = p;
+                b.first = p;
+                b.hasPoints = true;
+            }
+            else
+            {
+                if (p.x < b.min.x) b.min.x = p.x;
+                if (p.y < b.min.y) b.min.y = p.y;
+                if (p.x > b.max.x) b.max.x = p.x;
+                if (p.y > b.max.y) b.max.y = p.y;
+            }
+
+            b.last = p;
+        }
+    }
+
+    struct Query
+    {
+        double tolerance = 0.0;          // world units
+        const WorldRect *view = nullptr; // optional culling rectangle
+    };
+
+    // Appends to `out` a point sequence equivalent to the live range [begin, end) within
+    // `query.tolerance`. Break markers are kept, so the output can be drawn with the same
+    // rules as the raw trajectory. Buckets outside `query.view` are replaced by their first
+    // point, a break and their last point, which keeps segments crossing the view edge.
+    // rawAt(i) must return the point with absolute index i.
+    // Returns the number of points that were culled this way.
+    template <typename RawAt>
+    std::uint64_t simplify(std::uint64_t begin,
+                           std::uint64_t end,
+                           const Query &query,
+                           RawAt &&rawAt,
+                           std::vector<Vector2> &out) const
+    {
+        if (begin >= end || levels_.empty())
+        {
+            return 0;
+        }
+
+        const std::size_t top = levels_.size() - 1;
+        const unsigned shift = shiftForLevel(top);
+
+        std::uint64_t culled = 0;
+
+        for (std::uint64_t j = begin >> shift; j <= (end - 1) >> shift; ++j)
+        {
+            emitBucket(top, j, begin, end, query, rawAt, out, culled);
+        }
+
+        return culled;
+    }
+
+private:
+    struct Level
+    {
+        std::vector<Bucket> buckets;
+        std::size_t slots = 0;   // ring size; 0 = grows without bound
+    };
+
+    static unsigned shiftForLevel(std::size_t level)
+    {
+        return baseShift + static_cast<unsigned>(level);
+    }
+
+    Bucket& bucketForWrite(std::size_t level, std::uint64_t bucketIndex)
+    {
+        Level &lv = levels_[level];
+
+        if (lv.slots == 0)
+        {
+            if (bucketIndex >= lv.buckets.size())
+            {
+                lv.buckets.resize(static_cast<std::size_t>(bucketIndex) + 1);
+            }
+            return lv.buckets[static_cast<std::size_t>(bucketIndex)];
+        }
+
+        return lv.buckets[static_cast<std::size_t>(bucketIndex & (lv.slots - 1))];
+    }
+
+    const Bucket& bucketAt(std::size_t level, std::uint64_t bucketIndex) const
+    {
+        const Level &lv = levels_[level];
+
+        if (lv.slots == 0)
+        {
+            return lv.buckets[static_cast<std::size_t>(bucketIndex)];
+        }
+
+        return lv.buckets[static_cast<std::size_t>(bucketIndex & (lv.slots - 1))];
+    }
+
+    template <typename RawAt>
+    void emitBucket(std::size_t level,
+                    std::uint64_t bucketIndex,
+                    std::uint64_t begin,
+                    std::uint64_t end,
+                    const Query &query,
+                    RawAt &rawAt,
+                    std::vector<Vector2> &out,
+                    std::uint64_t &culled) const
+    {
+        const unsigned shift = shiftForLevel(level);
+        const std::uint64_t lo = bucketIndex << shift;
+        const std::uint64_t hi = lo + (std::uint64_t(1) << shift);
+
+        if (lo >= end || hi <= begin)
+        {
+            return;
+        }
+
+        // Only buckets that lie completely inside the live range hold a valid summary:
+        // the first one may be partly evicted and the last one may still be filling.
+        if (lo >= begin && hi <= end)
+        {
+            const Bucket &b = bucketAt(level, bucketIndex);
+
+            if (query.view != nullptr && (!b.hasPoints || !query.view->intersects(b.min, b.max)))
+            {
+                const double nanValue = std::numeric_limits<double>::quiet_NaN();
+
+                if (b.hasPoints)
+                {
+                    // With a break in the bucket, first and last may not connect
+                    // to the neighbouring buckets either.
+                    if (b.hasBreak)
+                    {
+                        out.push_back(Vector2(nanValue, nanValue));
+                    }
+
+                    out.push_back(b.first);
+                    out.push_back(Vector2(nanValue, nanValue));
+                    out.push_back(b.last);
+
+                    if (b.hasBreak)
+                    {
+                        out.push_back(Vector2(nanValue, nanValue));
+                    }
+                }
+                else
+                {
+                    out.push_back(Vector2(nanValue, nanValue));
+                }
+
+                culled += hi - lo;
+                return;
+            }
+
+            if (b.hasPoints && !b.hasBreak)
+            {
+                const double extentX = b.max.x - b.min.x;
+                const double extentY = b.max.y - b.min.y;
+
+                if (extentX <= query.tolerance && extentY <= query.tolerance)
+                {
+                    out.push_back(b.first);
+                    out.push_back(b.last);
+                    return;
+                }
+            }
+        }
+
+        if (level == 0)
+        {
+            const std::uint64_t from = (lo > begin) ? lo : begin;
+            const std::uint64_t to = (hi < end) ? hi : end;
+
+            for (std::uint64_t i = from; i < to; ++i)
+            {
+                out.push_back(rawAt(i));
+            }
+            return;
+        }
+
+        emitBucket(level - 1, bucketIndex * 2, begin, end, query, rawAt, out, culled);
+        emitBucket(level - 1, bucketIndex * 2 + 1, begin, end, query, rawAt, out, culled);
+    }
+
+    std::vector<Level> levels_;
+    std::size_t capacity_ = 0;
+};
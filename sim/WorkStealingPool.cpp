@@ -0,0 +1,139 @@
+#include "WorkStealingPool.h"
+
+#include <utility>
+
+WorkStealingPool::WorkStealingPool(std::size_t threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    if (threadCount == 0)
+    {
+        threadCount = 1;
+    }
+
+    for (std::size_t i = 0; i < threadCount; ++i)
+    {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+
+    for (std::size_t i = 0; i < threadCount; ++i)
+    {
+        threads_.emplace_back(&WorkStealingPool::run, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    wait();
+
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_all();
+
+    for (std::thread &thread : threads_)
+    {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::submit(std::function<void()> task)
+{
+    const std::size_t index = nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+
+    // Counted before it becomes visible, so a worker that takes the task
+    // right away never decrements the counters below zero. A worker that sees
+    // the count before the push just retries until the task is there.
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        ++queued_;
+        ++pending_;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    workAvailable_.notify_one();
+}
+
+void WorkStealingPool::wait()
+{
+    std::unique_lock<std::mutex> lock(stateMutex_);
+    idle_.wait(lock, [this]() { return pending_ == 0; });
+}
+
+std::size_t WorkStealingPool::threadCount() const
+{
+    return threads_.size();
+}
+
+void WorkStealingPool::run(std::size_t index)
+{
+    std::function<void()> task;
+
+    while (true)
+    {
+        if (popLocal(index, task) || steal(index, task))
+        {
+            {
+                std::lock_guard<std::mutex> lock(stateMutex_);
+                --queued_;
+            }
+
+            task();
+            task = nullptr;
+
+            std::lock_guard<std::mutex> lock(stateMutex_);
+            if (--pending_ == 0)
+            {
+                idle_.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(stateMutex_);
+        workAvailable_.wait(lock, [this]() { return queued_ > 0 || stopping_; });
+
+        if (stopping_ && queued_ == 0)
+        {
+            return;
+        }
+    }
+}
+
+bool WorkStealingPool::popLocal(std::size_t index, std::function<void()> &task)
+{
+    Queue &queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.tasks.empty())
+    {
+        return false;
+    }
+
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(std::size_t index, std::function<void()> &task)
+{
+    for (std::size_t offset = 1; offset < queues_.size(); ++offset)
+    {
+        Queue &victim = *queues_[(index + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads with one task deque each.
+//
+// submit() deals tasks round-robin onto the deques. A worker takes tasks from
+// the back of its own deque and, when that is empty, steals from the front of
+// the others, so uneven task costs (a flyby cell takes far longer than a miss)
+// even out without a central queue. Each deque has its own small mutex.
+class WorkStealingPool
+{
+public:
+    // threadCount == 0 uses std::thread::hardware_concurrency().
+    explicit WorkStealingPool(std::size_t threadCount = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    // Blocks until every submitted task has finished.
+    void wait();
+
+    std::size_t threadCount() const;
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void run(std::size_t index);
+    bool popLocal(std::size_t index, std::function<void()> &task);
+    bool steal(std::size_t index, std::function<void()> &task);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<std::size_t> nextQueue_{0};
+
+    std::mutex stateMutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable idle_;
+    std::size_t queued_ = 0;   // tasks sitting in a deque
+    std::size_t pending_ = 0;  // tasks submitted but not finished
+    bool stopping_ = false;
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Minimal timing harness for the benchmark executables.
+// Each benchmark runs a few warmup iterations, then `repetitions` timed
+// iterations; the median time per iteration is reported.
+namespace bench
+{
+    struct Result
+    {
+        std::string name;
+        double nsPerOp = 0.0;        // median wall time per iteration
+        double itemsPerSecond = 0.0; // items processed per second at the median
+        std::size_t repetitions = 0;
+    };
+
+    struct Options
+    {
+        int warmup = 3;
+        int repetitions = 15;
+    };
+
+    // Prevents the compiler from optimizing away a computed value.
+    template <typename T>
+    inline void doNotOptimize(const T &value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static const void *volatile sink = nullptr;
+        sink = &value;
+#endif
+    }
+
+    // fn() performs one iteration that processes `itemsPerOp` items.
+    template <typename Fn>
+    Result run(const std::string &name, std::size_t itemsPerOp, Fn &&fn, const Options &options = Options())
+    {
+        using Clock = std::chrono::steady_clock;
+
+        for (int i = 0; i < options.warmup; ++i)
+        {
+            fn();
+        }
+
+        std::vector<double> samples;
+        samples.reserve(static_cast<std::size_t>(options.repetitions));
+
+        for (int i = 0; i < options.repetitions; ++i)
+        {
+            const Clock::time_point start = Clock::now();
+            fn();
+            const Clock::time_point stop = Clock::now();
+
+            samples.push_back(std::chrono::duration<double, std::nano>(stop - start).count());
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        Result result;
+        result.name = name;
+        result.nsPerOp = samples[samples.size() / 2];
+        result.itemsPerSecond = (result.nsPerOp > 0.0) ? static_cast<double>(itemsPerOp) * 1e9 / result.nsPerOp : 0.0;
+        result.repetitions = samples.size();
+
+        return result;
+    }
+
+    inline void printHeader()
+    {
+        std::printf("%-48s %16s %16s\n", "benchmark", "ns/op", "items/s");
+    }
+
+    inline void print(const Result &result)
+    {
+        std::printf("%-48s %16.1f %16.4g\n", result.name.c_str(), result.nsPerOp, result.itemsPerSecond);
+    }
+
+    // Machine-readable output for tracking results across builds. Benchmark
+    // names are plain identifiers (letters, digits, '/', '_', '@'), so
+    // neither format needs escaping.
+    inline void writeCsv(std::FILE *out, const std::vector<Result> &results)
+    {
+        std::fprintf(out, "name,ns_per_op,items_per_second,repetitions\n");
+        for (const Result &r : results)
+        {
+            std::fprintf(out, "%s,%.3f,%.6g,%zu\n", r.name.c_str(), r.nsPerOp, r.itemsPerSecond, r.repetitions);
+        }
+    }
+
+    inline void writeJson(std::FILE *out, const std::vector<Result> &results)
+    {
+        std::fprintf(out, "{\n  \"benchmarks\": [");
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const Result &r = results[i];
+            std::fprintf(out, "%s\n    { \"name\": \"%s\", \"ns_per_op\": %.3f, \"items_per_second\": %.6g, \"repetitions\": %zu }",
+                         (i == 0) ? "" : ",", r.name.c_str(), r.nsPerOp, r.itemsPerSecond, r.repetitions);
+        }
+        std::fprintf(out, "\n  ]\n}\n");
+    }
+}
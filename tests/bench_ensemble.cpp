@@ -0,0 +1,129 @@
+// Ensemble propagation benchmark: particle-steps per second for 10k particles
+// around the Sun with Jupiter on its circular orbit.
+//
+// "aos" steps a std::vector<State2> with stepRK4 and a PointMassField, the
+// way a loop over SimulationControllers would; "soa" cases use
+// EnsemblePropagator with its scalar and widest compiled kernel. The GFLOP/s
+// column counts about 144 floating-point operations (sqrt and division as
+// one each) per RK4 particle-step with two bodies.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+#include "BenchHarness.h"
+#include "../core/Dynamics.h"
+#include "../core/PointMassField.h"
+#include "../sim/EnsemblePropagator.h"
+
+int main()
+{
+    const double AU_KM = 149597870.7;
+    const double MU_SUN = 1.32712440018e11;
+    const double MU_JUPITER = 1.26686534e8;
+    const std::size_t particles = 10000;
+    const std::size_t steps = 20;
+    const double dt = 3600.0;
+    const double rkFlopsPerParticleStep = 144.0;
+
+    const double jupiterRadius = 5.204 * AU_KM;
+
+    EnsembleBody sun;
+    sun.mu = MU_SUN;
+
+    EnsembleBody jupiter;
+    jupiter.mu = MU_JUPITER;
+    jupiter.orbitRadius = jupiterRadius;
+    jupiter.angularSpeed = std::sqrt(MU_SUN / (jupiterRadius * jupiterRadius * jupiterRadius));
+
+    // A fan of departures from 1 AU with different speeds and directions.
+    std::vector<State2> initial(particles);
+    for (std::size_t i = 0; i < particles; ++i)
+    {
+        const double speed = 30.0 + 15.0 * static_cast<double>(i % 100) / 100.0;
+        const double angle = 1.5 + 0.2 * static_cast<double>(i / 100) / 100.0;
+
+        initial[i].position = Vector2(AU_KM, 0.0);
+        initial[i].velocity = Vector2(speed * std::cos(angle), speed * std::sin(angle));
+    }
+
+    EnsemblePropagator ensemble;
+    ensemble.addBody(sun);
+    ensemble.addBody(jupiter);
+    ensemble.reserve(particles);
+    for (const State2 &s : initial)
+    {
+        ensemble.add(s);
+    }
+
+    const std::size_t items = particles * steps;
+
+    const auto printWithFlops = [&](const bench::Result &result, double flopsPerItem)
+    {
+        bench::print(result);
+        if (flopsPerItem > 0.0)
+        {
+            std::printf("%-48s %16s %13.2f GFLOP/s\n", "", "", result.itemsPerSecond * flopsPerItem * 1e-9);
+        }
+    };
+
+    std::printf("ensemble kernel: %s\n", EnsemblePropagator::simdLevel());
+    bench::printHeader();
+
+    std::vector<State2> aos = initial;
+    printWithFlops(bench::run("aos/rk4", items, [&]()
+    {
+        for (std::size_t s = 0; s < steps; ++s)
+        {
+            PointMassField field;
+            field.add(sun.positionAt(0.0), sun.mu);
+            field.add(jupiter.positionAt(static_cast<double>(s) * dt), jupiter.mu);
+
+            for (State2 &state : aos)
+            {
+                state = stepRK4(state, dt, field);
+            }
+        }
+        bench::doNotOptimize(aos);
+    }), rkFlopsPerParticleStep);
+
+    ensemble.setVectorized(false);
+    printWithFlops(bench::run("soa/rk4/scalar", items, [&]()
+    {
+        for (std::size_t s = 0; s < steps; ++s)
+        {
+            ensemble.step(dt, EnsemblePropagator::Method::RK4);
+        }
+        bench::doNotOptimize(ensemble.x());
+    }), rkFlopsPerParticleStep);
+
+    ensemble.setVectorized(true);
+    printWithFlops(bench::run("soa/rk4/simd", items, [&]()
+    {
+        for (std::size_t s = 0; s < steps; ++s)
+        {
+            ensemble.step(dt, EnsemblePropagator::Method::RK4);
+        }
+        bench::doNotOptimize(ensemble.x());
+    }), rkFlopsPerParticleStep);
+
+    printWithFlops(bench::run("soa/leapfrog/simd", items, [&]()
+    {
+        for (std::size_t s = 0; s < steps; ++s)
+        {
+            ensemble.step(dt, EnsemblePropagator::Method::Leapfrog);
+        }
+        bench::doNotOptimize(ensemble.x());
+    }), 0.0);
+
+    printWithFlops(bench::run("soa/yoshida4/simd", items, [&]()
+    {
+        for (std::size_t s = 0; s < steps; ++s)
+        {
+            ensemble.step(dt, EnsemblePropagator::Method::Yoshida4);
+        }
+        bench::doNotOptimize(ensemble.x());
+    }), 0.0);
+
+    return 0;
+}
@@ -0,0 +1,286 @@
+// Integrator benchmark.
+//
+// Part 1: cost per step with the force model passed as a std::function versus
+// as a template parameter. The force model is the one SimulationModel uses
+// (Sun + Jupiter as point masses, captured by reference), so the std::function
+// cases pay one type-erased call per stage while the template cases inline it.
+//
+// Part 2: work-precision. Each method propagates the same eccentric orbit for
+// one year at several step sizes / tolerances; the table lists wall time and
+// the final position error against a tight Taylor reference.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include "BenchHarness.h"
+#include "../core/Body.h"
+#include "../core/Dynamics.h"
+#include "../core/PointMassField.h"
+#include "../core/TaylorIntegrator.h"
+
+namespace
+{
+    struct PrecisionRow
+    {
+        std::string method;
+        std::string setting;
+        double ms = 0.0;
+        double errorKm = 0.0;
+    };
+
+    void printPrecisionHeader()
+    {
+        std::printf("\n%-12s %-16s %14s %16s\n", "method", "setting", "ms/year", "error [km]");
+    }
+
+    void printPrecision(const PrecisionRow &row)
+    {
+        std::printf("%-12s %-16s %14.3f %16.3e\n", row.method.c_str(), row.setting.c_str(), row.ms, row.errorKm);
+    }
+
+    std::string label(const char *name, double value)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%s=%g", name, value);
+        return buffer;
+    }
+
+    double distance(const State2 &a, const State2 &b)
+    {
+        return std::hypot(a.position.x - b.position.x, a.position.y - b.position.y);
+    }
+
+    // Times `propagate()` (which returns the final state) and compares it with `reference`.
+    template <typename Propagate>
+    PrecisionRow measure(const std::string &method, const std::string &setting, const State2 &reference, Propagate &&propagate)
+    {
+        bench::Options options;
+        options.warmup = 1;
+        options.repetitions = 5;
+
+        State2 final;
+        const bench::Result timing = bench::run(method, 1, [&]()
+        {
+            final = propagate();
+            bench::doNotOptimize(final);
+        }, options);
+
+        PrecisionRow row;
+        row.method = method;
+        row.setting = setting;
+        row.ms = timing.nsPerOp * 1e-6;
+        row.errorKm = distance(final, reference);
+        return row;
+    }
+}
+
+int main()
+{
+    const double AU_KM = 149597870.7;
+    const double MU_SUN = 1.32712440018e11;
+    const std::size_t steps = 10000;
+    const double dt = 3600.0;
+
+    Body sun;
+    sun.position = Vector2(0.0, 0.0);
+    sun.mu = MU_SUN;
+
+    Body jupiter;
+    jupiter.position = Vector2(5.204 * AU_KM, 0.0);
+    jupiter.mu = 1.26686534e8;
+
+    const auto field = [&sun, &jupiter](const Vector2 &pos)
+    {
+        return gravitaionalAccelerationFromBody(pos, sun) + gravitaionalAccelerationFromBody(pos, jupiter);
+    };
+    const AccelerationFunction erased = field;
+
+    State2 initial;
+    initial.position = Vector2(AU_KM, 0.0);
+    initial.velocity = Vector2(0.0, 40.0);
+
+    bench::printHeader();
+
+    bench::print(bench::run("euler/std_function", steps, [&]()
+    {
+        State2 s = initial;
+        for (std::size_t i = 0; i < steps; ++i)
+        {
+            s = stepEuler(s, dt, erased);
+        }
+        bench::doNotOptimize(s);
+    }));
+
+    bench::print(bench::run("euler/template", steps, [&]()
+    {
+        State2 s = initial;
+        for (std::size_t i = 0; i < steps; ++i)
+        {
+            s = stepEuler(s, dt, field);
+        }
+        bench::doNotOptimize(s);
+    }));
+
+    bench::print(bench::run("rk4/std_function", steps, [&]()
+    {
+        State2 s = initial;
+        for (std::size_t i = 0; i < steps; ++i)
+        {
+            s = stepRK4(s, dt, erased);
+        }
+        bench::doNotOptimize(s);
+    }));
+
+    bench::print(bench::run("rk4/template", steps, [&]()
+    {
+        State2 s = initial;
+        for (std::size_t i = 0; i < steps; ++i)
+        {
+            s = stepRK4(s, dt, field);
+        }
+        bench::doNotOptimize(s);
+    }));
+
+    bench::print(bench::run("leapfrog/template", steps, [&]()
+    {
+        State2 s = initial;
+        for (std::size_t i = 0; i < steps; ++i)
+        {
+            s = stepLeapfrog(s, dt, field);
+        }
+        bench::doNotOptimize(s);
+    }));
+
+    bench::print(bench::run("yoshida4/template", steps, [&]()
+    {
+        State2 s = initial;
+        for (std::size_t i = 0; i < steps; ++i)
+        {
+            s = stepYoshida4(s, dt, field);
+        }
+        bench::doNotOptimize(s);
+    }));
+
+    bench::print(bench::run("yoshida6/template", steps, [&]()
+    {
+        State2 s = initial;
+        for (std::size_t i = 0; i < steps; ++i)
+        {
+            s = stepYoshida6(s, dt, field);
+        }
+        bench::doNotOptimize(s);
+    }));
+
+    bench::print(bench::run("abm4/template", steps, [&]()
+    {
+        State2 s = initial;
+        MultistepHistory history;
+        for (std::size_t i = 0; i < steps; ++i)
+        {
+            s = stepAdamsBashforthMoulton4(s, dt, field, history);
+        }
+        bench::doNotOptimize(s);
+    }));
+
+    // One interval per "step"; the adaptive step is warm-started across intervals.
+    const AdaptiveStepOptions options;
+
+    bench::print(bench::run("dp45/std_function", steps, [&]()
+    {
+        State2 s = initial;
+        AdaptiveStepStats stats;
+        double h = 0.0;
+        for (std::size_t i = 0; i < steps; ++i)
+        {
+            s = stepDormandPrince45(s, dt, h, erased, options, stats);
+        }
+        bench::doNotOptimize(s);
+    }));
+
+    bench::print(bench::run("dp45/template", steps, [&]()
+    {
+        State2 s = initial;
+        AdaptiveStepStats stats;
+        double h = 0.0;
+        for (std::size_t i = 0; i < steps; ++i)
+        {
+            s = stepDormandPrince45(s, dt, h, field, options, stats);
+        }
+        bench::doNotOptimize(s);
+    }));
+
+    // Work-precision over one year of an eccentric orbit (1.2x circular speed at 1 AU).
+    const double year = 365.25 * 86400.0;
+
+    PointMassField pointMasses;
+    pointMasses.add(sun);
+    pointMasses.add(jupiter);
+
+    State2 orbitStart;
+    orbitStart.position = Vector2(AU_KM, 0.0);
+    orbitStart.velocity = Vector2(0.0, 1.2 * std::sqrt(MU_SUN / AU_KM));
+
+    TaylorOptions referenceOptions;
+    referenceOptions.tolerance = 1e-18;
+    referenceOptions.maxOrder = 30;
+    referenceOptions.maxStep = 86400.0;
+    AdaptiveStepStats referenceStats;
+    const State2 reference = stepTaylor(orbitStart, year, pointMasses, referenceOptions, referenceStats);
+
+    printPrecisionHeader();
+
+    // stepFn(state, h, history) takes one step; history is fresh for every run.
+    const auto fixedStep = [&](const std::string &method, auto stepFn)
+    {
+        for (const double hours : { 24.0, 6.0, 1.0 })
+        {
+            const double h = hours * 3600.0;
+            const long count = static_cast<long>(std::ceil(year / h));
+
+            printPrecision(measure(method, label("dt[h]", hours), reference, [&]()
+            {
+                State2 s = orbitStart;
+                MultistepHistory history;
+                for (long i = 0; i < count; ++i)
+                {
+                    s = stepFn(s, year / count, history);
+                }
+                return s;
+            }));
+        }
+    };
+
+    fixedStep("rk4", [&](const State2 &s, double h, MultistepHistory&) { return stepRK4(s, h, field); });
+    fixedStep("yoshida6", [&](const State2 &s, double h, MultistepHistory&) { return stepYoshida6(s, h, field); });
+    fixedStep("abm4", [&](const State2 &s, double h, MultistepHistory &history)
+    {
+        return stepAdamsBashforthMoulton4(s, h, field, history);
+    });
+
+    for (const double tol : { 1e-8, 1e-10, 1e-12 })
+    {
+        printPrecision(measure("dp45", label("rtol", tol), reference, [&]()
+        {
+            AdaptiveStepOptions dpOptions;
+            dpOptions.relTol = tol;
+            dpOptions.absTol = 1e-9;
+            AdaptiveStepStats stats;
+            double h = 0.0;
+            return stepDormandPrince45(orbitStart, year, h, field, dpOptions, stats);
+        }));
+    }
+
+    for (const double tol : { 1e-10, 1e-13, 1e-16 })
+    {
+        printPrecision(measure("taylor", label("tol", tol), reference, [&]()
+        {
+            TaylorOptions taylorOptions;
+            taylorOptions.tolerance = tol;
+            AdaptiveStepStats stats;
+            return stepTaylor(orbitStart, year, pointMasses, taylorOptions, stats);
+        }));
+    }
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+// ScreenSpaceConverter benchmark: per-point transform cost.
+//
+// "legacy" is the old toScreen(), which recomputed the scale and centres for
+// every point; "scalar" is the current per-point toScreen() with the cached
+// transform, and "batch" maps the whole array with the span overload.
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include "BenchHarness.h"
+#include "ScreenSpaceConverter.h"
+
+static ScreenPoint legacyToScreen(const Vector2 &world,
+                                  double worldMinX, double worldMaxX,
+                                  double worldMinY, double worldMaxY,
+                                  int screenWidth, int screenHeight)
+{
+    ScreenPoint result;
+    result.x = 0.0;
+    result.y = 0.0;
+
+    if (screenWidth <= 0 || screenHeight <= 0)
+    {
+        return result;
+    }
+
+    const double worldWidth = worldMaxX - worldMinX;
+    const double worldHeight = worldMaxY - worldMinY;
+
+    if (worldWidth <= 0.0 || worldHeight <= 0.0)
+    {
+        result.x = static_cast<double>(screenWidth) * 0.5;
+        result.y = static_cast<double>(screenHeight) * 0.5;
+        return result;
+    }
+
+    const double scaleX = static_cast<double>(screenWidth) / worldWidth;
+    const double scaleY = static_cast<double>(screenHeight) / worldHeight;
+
+    const double scale = (scaleX < scaleY) ? scaleX : scaleY;
+
+    const double worldCenterX = 0.5 * (worldMinX + worldMaxX);
+    const double worldCenterY = 0.5 * (worldMinY + worldMaxY);
+
+    const double screenCenterX = static_cast<double>(screenWidth) * 0.5;
+    const double screenCenterY = static_cast<double>(screenHeight) * 0.5;
+
+    const double dx = world.x - worldCenterX;
+    const double dy = world.y - worldCenterY;
+
+    result.x = screenCenterX + dx * scale;
+    result.y = screenCenterY - dy * scale;
+
+    return result;
+}
+
+int main()
+{
+    const double AU_KM = 149597870.7;
+    const std::size_t count = 10000;
+
+    const double minX = -10.0 * AU_KM;
+    const double maxX = 10.0 * AU_KM;
+    const double minY = -10.0 * AU_KM;
+    const double maxY = 10.0 * AU_KM;
+    const int width = 800;
+    const int height = 600;
+
+    std::vector<Vector2> world(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const double t = static_cast<double>(i) * 1e-3;
+        world[i] = Vector2(AU_KM * std::cos(t), AU_KM * std::sin(t));
+    }
+
+    // A break marker every 1000 points, as left by resets.
+    const double nanValue = std::numeric_limits<double>::quiet_NaN();
+    for (std::size_t i = 0; i < count; i += 1000)
+    {
+        world[i] = Vector2(nanValue, nanValue);
+    }
+
+    ScreenSpaceConverter converter;
+    converter.setScreenSize(width, height);
+    converter.setWorldBounds(minX, maxX, minY, maxY);
+
+    std::vector<ScreenPoint> out(count);
+
+    bench::printHeader();
+
+    bench::print(bench::run("to_screen/legacy", count, [&]()
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            out[i] = legacyToScreen(world[i], minX, maxX, minY, maxY, width, height);
+        }
+        bench::doNotOptimize(out);
+    }));
+
+    bench::print(bench::run("to_screen/scalar", count, [&]()
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            out[i] = converter.toScreen(world[i]);
+        }
+        bench::doNotOptimize(out);
+    }));
+
+    bench::print(bench::run("to_screen/batch", count, [&]()
+    {
+        converter.toScreen(world, out.data());
+        bench::doNotOptimize(out);
+    }));
+
+    return 0;
+}
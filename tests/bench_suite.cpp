@@ -0,0 +1,292 @@
+// Regression benchmark suite for the hot paths of the core, sim and view code.
+//
+// Every case runs a batch of items per iteration (see the items/s column) so
+// the timer resolution does not matter; ns/op is the median time of a batch.
+// Needs no Qt, so it runs on headless build boxes.
+//
+//   bench_suite [--format=text|csv|json] [--output=PATH] [--filter=SUBSTRING]
+//               [--warmup=N] [--repetitions=N]
+//
+// Text goes to stdout; csv and json go to --output if given.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "BenchHarness.h"
+#include "ScreenSpaceConverter.h"
+#include "../core/Body.h"
+#include "../core/Dynamics.h"
+#include "../core/OrbitUtils.h"
+#include "../sim/SimulationModel.h"
+#include "../sim/TrajectoryBuffer.h"
+
+namespace
+{
+    struct Settings
+    {
+        std::string format = "text";
+        std::string outputPath;
+        std::string filter;
+        bench::Options options;
+    };
+
+    void printUsage()
+    {
+        std::printf("usage: bench_suite [--format=text|csv|json] [--output=PATH] [--filter=SUBSTRING]\n"
+                    "                   [--warmup=N] [--repetitions=N]\n");
+    }
+
+    // Returns false (after printing why) on a bad argument.
+    bool parseArguments(int argc, char *argv[], Settings &settings)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            const std::size_t eq = arg.find('=');
+
+            if (arg.rfind("--", 0) != 0 || eq == std::string::npos)
+            {
+                std::fprintf(stderr, "expected --key=value, got '%s'\n", arg.c_str());
+                return false;
+            }
+
+            const std::string key = arg.substr(2, eq - 2);
+            const std::string value = arg.substr(eq + 1);
+
+            if (key == "format" && (value == "text" || value == "csv" || value == "json"))
+            {
+                settings.format = value;
+            }
+            else if (key == "output")
+            {
+                settings.outputPath = value;
+            }
+            else if (key == "filter")
+            {
+                settings.filter = value;
+            }
+            else if (key == "warmup" && std::atoi(value.c_str()) >= 0)
+            {
+                settings.options.warmup = std::atoi(value.c_str());
+            }
+            else if (key == "repetitions" && std::atoi(value.c_str()) > 0)
+            {
+                settings.options.repetitions = std::atoi(value.c_str());
+            }
+            else
+            {
+                std::fprintf(stderr, "bad option '%s'\n", arg.c_str());
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Positions on a spiral from 0.5 to 6 AU, so the gravity and orbit cases
+    // see a spread of distances instead of one cached value.
+    std::vector<Vector2> spiralPositions(std::size_t count)
+    {
+        std::vector<Vector2> positions(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const double f = static_cast<double>(i) / static_cast<double>(count);
+            const double r = (0.5 + 5.5 * f) * AU_KM;
+            const double angle = 40.0 * f;
+            positions[i] = Vector2(r * std::cos(angle), r * std::sin(angle));
+        }
+        return positions;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc == 2 && (std::string(argv[1]) == "--help" || std::string(argv[1]) == "-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    Settings settings;
+    if (!parseArguments(argc, argv, settings))
+    {
+        printUsage();
+        return 2;
+    }
+
+    std::vector<bench::Result> results;
+    const bool text = settings.format == "text";
+
+    if (text)
+    {
+        bench::printHeader();
+    }
+
+    const auto add = [&](const std::string &name, std::size_t itemsPerOp, auto &&fn)
+    {
+        if (!settings.filter.empty() && name.find(settings.filter) == std::string::npos)
+        {
+            return;
+        }
+
+        results.push_back(bench::run(name, itemsPerOp, fn, settings.options));
+
+        if (text)
+        {
+            bench::print(results.back());
+        }
+    };
+
+    const double dt = 3600.0;
+    const std::size_t batch = 4096;
+    const std::vector<Vector2> positions = spiralPositions(batch);
+
+    Body sun;
+    sun.position = Vector2(0.0, 0.0);
+    sun.mu = MU_SUN;
+
+    Body jupiter;
+    jupiter.position = Vector2(5.204 * AU_KM, 0.0);
+    jupiter.mu = 1.26686534e8;
+
+    State2 initial;
+    initial.position = Vector2(AU_KM, 0.0);
+    initial.velocity = Vector2(0.0, 40.0);
+
+    add("dynamics/gravitational_acceleration", batch, [&]()
+    {
+        Vector2 sum(0.0, 0.0);
+        for (const Vector2 &p : positions)
+        {
+            sum = sum + gravitaionalAccelerationFromBody(p, sun);
+        }
+        bench::doNotOptimize(sum);
+    });
+
+    const std::size_t steps = 1000;
+
+    add("dynamics/rk4_mu", steps, [&]()
+    {
+        State2 s = initial;
+        for (std::size_t i = 0; i < steps; ++i)
+        {
+            s = stepRK4(s, dt, MU_SUN);
+        }
+        bench::doNotOptimize(s);
+    });
+
+    // Sun + Jupiter through the std::function overload.
+    const AccelerationFunction field = [&sun, &jupiter](const Vector2 &pos)
+    {
+        return gravitaionalAccelerationFromBody(pos, sun) + gravitaionalAccelerationFromBody(pos, jupiter);
+    };
+
+    add("dynamics/rk4_std_function", steps, [&]()
+    {
+        State2 s = initial;
+        for (std::size_t i = 0; i < steps; ++i)
+        {
+            s = stepRK4(s, dt, field);
+        }
+        bench::doNotOptimize(s);
+    });
+
+    add("orbit/make_orbit_state", batch, [&]()
+    {
+        double sum = 0.0;
+        for (const Vector2 &p : positions)
+        {
+            // 1.1x circular speed, prograde: a spread of ellipses.
+            const double r = std::hypot(p.x, p.y);
+            const double speed = 1.1 * std::sqrt(MU_SUN / r);
+            const Vector2 velocity(-p.y * speed / r, p.x * speed / r);
+            sum += makeOrbitState(p, velocity, MU_SUN).eccentricity;
+        }
+        bench::doNotOptimize(sum);
+    });
+
+    // Every append evicts the oldest point.
+    const std::size_t trailCapacity = 100000;
+    TrajectoryBuffer trail(trailCapacity);
+    for (std::size_t i = 0; i < trailCapacity; ++i)
+    {
+        trail.addPoint(positions[i % batch]);
+    }
+
+    add("trail/add_point_full", batch, [&]()
+    {
+        for (const Vector2 &p : positions)
+        {
+            trail.addPoint(p);
+        }
+        bench::doNotOptimize(trail);
+    });
+
+    ScreenSpaceConverter converter;
+    converter.setWorldBounds(-6.0 * AU_KM, 6.0 * AU_KM, -6.0 * AU_KM, 6.0 * AU_KM);
+    converter.setScreenSize(1920, 1080);
+    std::vector<ScreenPoint> screen(batch);
+
+    add("view/to_screen", batch, [&]()
+    {
+        for (std::size_t i = 0; i < batch; ++i)
+        {
+            screen[i] = converter.toScreen(positions[i]);
+        }
+        bench::doNotOptimize(screen);
+    });
+
+    add("view/to_screen_batch", batch, [&]()
+    {
+        converter.toScreen(positions, screen.data());
+        bench::doNotOptimize(screen);
+    });
+
+    // Default GUI setup: RK4, Sun + Jupiter, trails and keyframes on. The model
+    // keeps running across repetitions, like it does in the application.
+    SimulationModel model(initial, MU_SUN, 0.1);
+    const std::size_t updates = 1000;
+
+    add("model/update", updates, [&]()
+    {
+        for (std::size_t i = 0; i < updates; ++i)
+        {
+            model.update();
+        }
+        bench::doNotOptimize(model.state());
+    });
+
+    if (text)
+    {
+        return 0;
+    }
+
+    std::FILE *out = stdout;
+    if (!settings.outputPath.empty())
+    {
+        out = std::fopen(settings.outputPath.c_str(), "w");
+        if (!out)
+        {
+            std::fprintf(stderr, "cannot write '%s'\n", settings.outputPath.c_str());
+            return 1;
+        }
+    }
+
+    if (settings.format == "json")
+    {
+        bench::writeJson(out, results);
+    }
+    else
+    {
+        bench::writeCsv(out, results);
+    }
+
+    if (out != stdout)
+    {
+        std::fclose(out);
+    }
+
+    return 0;
+}
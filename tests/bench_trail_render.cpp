@@ -0,0 +1,135 @@
+// Trail rendering benchmark: frame time against trail length.
+//
+// "per-segment" reproduces the old OrbitViewWidget loop (one drawLine per
+// segment over every stored point); "polyline" is TrailRenderer with the LOD
+// disabled, and "polyline+lod" is TrailRenderer as the widget uses it.
+// "polyline+lod/zoomed" draws the same trail into a view showing a small part
+// of it, where most of the history is culled.
+
+#include <QGuiApplication>
+#include <QImage>
+#include <QPainter>
+#include <QPen>
+#include <cmath>
+#include <string>
+#include "BenchHarness.h"
+#include "ScreenSpaceConverter.h"
+#include "TrailRenderer.h"
+
+static void fillSpiral(TrajectoryBuffer &trail, std::size_t count)
+{
+    const double AU_KM = 149597870.7;
+
+    trail.clear();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const double t = static_cast<double>(i) * 1e-3;
+        const double r = AU_KM * (1.0 + 0.02 * t);
+        trail.addPoint(Vector2(r * std::cos(t), r * std::sin(t)));
+    }
+}
+
+static void drawPerSegment(QPainter &painter, const TrajectoryBuffer &trail, const ScreenSpaceConverter &converter, const QPen &pen)
+{
+    painter.setPen(pen);
+
+    QPointF prev;
+    bool first = true;
+
+    trail.forEach([&](const Vector2 &p)
+    {
+        if (TrajectoryBuffer::isBreakPoint(p))
+        {
+            first = true;
+            return;
+        }
+
+        const ScreenPoint sp = converter.toScreen(p);
+        const QPointF pt(sp.x, sp.y);
+
+        if (!first)
+        {
+            painter.drawLine(prev, pt);
+        }
+
+        prev = pt;
+        first = false;
+    });
+}
+
+template <typename DrawFn>
+static void renderFrame(QImage &image, DrawFn &&drawTrail)
+{
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.fillRect(image.rect(), QColor(10, 10, 30));
+    drawTrail(painter);
+}
+
+int main(int argc, char *argv[])
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+
+    const int width = 800;
+    const int height = 600;
+    const double AU_KM = 149597870.7;
+
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+
+    ScreenSpaceConverter converter;
+    converter.setScreenSize(width, height);
+    converter.setWorldBounds(-10.0 * AU_KM, 10.0 * AU_KM, -10.0 * AU_KM, 10.0 * AU_KM);
+
+    QPen pen(Qt::cyan);
+    pen.setWidth(2);
+
+    const double lodTolerance = 0.5 * converter.worldUnitsPerPixel();
+    const WorldRect view = converter.visibleWorldRect();
+
+    // Zoomed-in view of a small part of the spiral, to show the effect of culling.
+    ScreenSpaceConverter zoomed;
+    zoomed.setScreenSize(width, height);
+    zoomed.setWorldBounds(0.5 * AU_KM, 1.5 * AU_KM, -0.5 * AU_KM, 0.5 * AU_KM);
+
+    const double zoomedTolerance = 0.5 * zoomed.worldUnitsPerPixel();
+    const WorldRect zoomedView = zoomed.visibleWorldRect();
+
+    bench::Options options;
+    options.warmup = 2;
+    options.repetitions = 9;
+
+    TrailRenderer renderer;
+
+    bench::printHeader();
+
+    for (std::size_t count : { std::size_t(1000), std::size_t(10000), std::size_t(100000) })
+    {
+        TrajectoryBuffer trail(count);
+        fillSpiral(trail, count);
+
+        const std::string suffix = "/" + std::to_string(count);
+
+        bench::print(bench::run("trail_frame/per-segment" + suffix, count, [&]()
+        {
+            renderFrame(image, [&](QPainter &painter) { drawPerSegment(painter, trail, converter, pen); });
+        }, options));
+
+        bench::print(bench::run("trail_frame/polyline" + suffix, count, [&]()
+        {
+            renderFrame(image, [&](QPainter &painter) { renderer.draw(painter, trail, converter, pen, -1.0, view); });
+        }, options));
+
+        bench::print(bench::run("trail_frame/polyline+lod" + suffix, count, [&]()
+        {
+            renderFrame(image, [&](QPainter &painter) { renderer.draw(painter, trail, converter, pen, lodTolerance, view); });
+        }, options));
+
+        bench::print(bench::run("trail_frame/polyline+lod/zoomed" + suffix, count, [&]()
+        {
+            renderFrame(image, [&](QPainter &painter) { renderer.draw(painter, trail, zoomed, pen, zoomedTolerance, zoomedView); });
+        }, options));
+    }
+
+    return 0;
+}